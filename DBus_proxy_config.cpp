@@ -203,97 +203,65 @@ static void log_message(const char* format, ...) {
     va_end(args);
 }
 
-// Forward property get requests to the source service
-static GVariant* handle_get_property(GDBusConnection *conn,
-                                    const char *sender,
-                                    const char *object_path,
-                                    const char *interface_name,
-                                    const char *property_name,
-                                    GError **error,
-                                    gpointer user_data)
+// Forward org.freedesktop.DBus.Properties Get/Set/GetAll calls to the source
+// service. get_property/set_property are left out of the vtable so GDBus hands
+// these to method_call, and we complete them asynchronously instead of blocking
+// the main loop for up to timeout_ms.
+static void handle_properties_call(const char *sender,
+                                   const char *method_name,
+                                   GVariant *parameters,
+                                   GDBusMethodInvocation *invocation)
 {
-    if (config.verbose) {
-        log_message("Getting property: %s.%s from %s\n", 
-                   interface_name, property_name, sender);
-    }
-    
-    GVariant *result = g_dbus_connection_call_sync(
-        source_bus,                            // Use source bus
-        config.source_bus_name.c_str(),
-        config.source_object_path.c_str(),
-        "org.freedesktop.DBus.Properties",
-        "Get",
-        g_variant_new("(ss)", interface_name, property_name),
-        G_VARIANT_TYPE("(v)"),
-        G_DBUS_CALL_FLAGS_NONE,
-        config.timeout_ms,
-        NULL,
-        error);
-    
-    if (!result) {
-        if (config.verbose) {
-            log_message("Failed to get property %s.%s: %s\n", 
-                       interface_name, property_name, 
-                       *error ? (*error)->message : "Unknown error");
-        }
-        return NULL;
-    }
-    
-    GVariant *value;
-    g_variant_get(result, "(v)", &value);
-    g_variant_unref(result);
-    
-    if (config.verbose) {
-        log_message("Property %s.%s retrieved successfully\n", interface_name, property_name);
+    const GVariantType *reply_type;
+    
+    if (g_strcmp0(method_name, "Get") == 0) {
+        reply_type = G_VARIANT_TYPE("(v)");
+    } else if (g_strcmp0(method_name, "Set") == 0) {
+        reply_type = G_VARIANT_TYPE("()");
+    } else if (g_strcmp0(method_name, "GetAll") == 0) {
+        reply_type = G_VARIANT_TYPE("(a{sv})");
+    } else {
+        g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD,
+                                              "Unknown method %s on org.freedesktop.DBus.Properties",
+                                              method_name);
+        return;
     }
     
-    return value;
-}
-
-// Forward property set requests to the source service
-static gboolean handle_set_property(GDBusConnection *conn,
-                                   const char *sender,
-                                   const char *object_path,
-                                   const char *interface_name,
-                                   const char *property_name,
-                                   GVariant *value,
-                                   GError **error,
-                                   gpointer user_data)
-{
     if (config.verbose) {
-        log_message("Setting property: %s.%s from %s\n", 
-                   interface_name, property_name, sender);
+        log_message("Forwarding property %s from %s\n", method_name, sender);
     }
     
-    GVariant *result = g_dbus_connection_call_sync(
+    g_dbus_connection_call(
         source_bus,                            // Use source bus
         config.source_bus_name.c_str(),
         config.source_object_path.c_str(),
         "org.freedesktop.DBus.Properties",
-        "Set",
-        g_variant_new("(ssv)", interface_name, property_name, value),
-        NULL,
+        method_name,
+        parameters,
+        reply_type,
         G_DBUS_CALL_FLAGS_NONE,
-        config.timeout_ms,
-        NULL,
-        error);
-    
-    if (!result) {
-        if (config.verbose) {
-            log_message("Failed to set property %s.%s: %s\n", 
-                       interface_name, property_name, 
-                       *error ? (*error)->message : "Unknown error");
-        }
-        return FALSE;
-    }
-    
-    g_variant_unref(result);
-    
-    if (config.verbose) {
-        log_message("Property %s.%s set successfully\n", interface_name, property_name);
-    }
-    
-    return TRUE;
+        config.timeout_ms, NULL,              // Timeout, cancellable
+        (GAsyncReadyCallback)[](GObject *source, GAsyncResult *res, gpointer user_data) {
+            GDBusMethodInvocation *inv = (GDBusMethodInvocation *)user_data;
+            const char *method = g_dbus_method_invocation_get_method_name(inv);
+            GError *error = NULL;
+            GVariant *result = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, &error);
+            
+            if (result) {
+                if (config.verbose) {
+                    log_message("Property %s succeeded\n", method);
+                }
+                g_dbus_method_invocation_return_value(inv, result);
+                g_variant_unref(result);
+            } else {
+                if (config.verbose) {
+                    log_message("Property %s failed: %s\n", method, error ? error->message : "Unknown error");
+                }
+                g_dbus_method_invocation_return_gerror(inv, error);
+                if (error) g_error_free(error);
+            }
+        },
+        invocation);
 }
 
 // Forward method calls to the source service
@@ -306,6 +274,11 @@ static void handle_method_call(GDBusConnection *conn,
                                GDBusMethodInvocation *invocation,
                                gpointer user_data)
 {
+    if (g_strcmp0(interface_name, "org.freedesktop.DBus.Properties") == 0) {
+        handle_properties_call(sender, method_name, parameters, invocation);
+        return;
+    }
+    
     if (config.verbose) {
         log_message("Forwarding method call: %s.%s from %s\n", 
                    interface_name, method_name, sender);
@@ -548,8 +521,8 @@ int main(int argc, char* argv[])
     // Register interfaces and subscribe to signals
     GDBusInterfaceVTable vtable = {
         .method_call = handle_method_call,
-        .get_property = handle_get_property,
-        .set_property = handle_set_property
+        .get_property = NULL,                 // Properties go through method_call (async)
+        .set_property = NULL
     };
 
     int interface_count = 0;
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+# Startup time with and without the on-disk introspection cache
+# (--introspection-cache) for source trees of 1,000 and 10,000 objects:
+# without a cache, cold (empty cache directory, filled by this start) and
+# warm (cache from the previous start). Startup ends when the proxy owns its
+# name; with a cache, the time until the background revalidation finished
+# is shown as well.
+#
+#   dbus-run-session -- python3 bench/cache-startup.py [path/to/dbus-proxy]
+
+import os
+import re
+import sys
+import tempfile
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "tests"))
+
+import proxytest
+
+TREES = [1000, 10000]
+
+
+# Start a proxy, time it until it owns its name and, when it started from a
+# cache, until it has revalidated it; returns (startup s, revalidation ms)
+def timed_start(revalidates, *options):
+    started = time.monotonic()
+    proxy = proxytest.start_proxy(*options)
+    startup = time.monotonic() - started
+    revalidated = None
+    try:
+        deadline = time.monotonic() + 120
+        while revalidates and revalidated is None and time.monotonic() < deadline:
+            for line in proxy.output():
+                match = re.search(r"Revalidated introspection cache in ([\d.]+) ms", line)
+                if match:
+                    revalidated = float(match.group(1))
+            time.sleep(0.05)
+    finally:
+        proxy.stop()
+    return startup, revalidated
+
+
+def main():
+    print("%8s %-8s %12s %16s" % ("objects", "start", "startup ms", "revalidated ms"))
+    for objects in TREES:
+        service = proxytest.start_service("--objects", str(objects))
+        try:
+            with tempfile.TemporaryDirectory() as cache:
+                runs = [("none", False, ()), ("cold", False, ("--introspection-cache", cache)),
+                        ("warm", True, ("--introspection-cache", cache))]
+                for label, revalidates, options in runs:
+                    startup, revalidated = timed_start(revalidates, *options)
+                    print("%8d %-8s %12.1f %16s" % (objects, label, startup * 1000,
+                                                    "%.1f" % revalidated if revalidated is not None else "-"))
+        finally:
+            service.stop()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+# Throughput of the two call forwarding engines across payload sizes: the
+# vtable engine, which unpacks and repacks every body, and the
+# message-level one (--message-forwarding), which relays bodies as they
+# are. Each call echoes its byte array back, so the payload crosses the
+# proxy twice.
+#
+#   dbus-run-session -- python3 bench/forwarding-throughput.py [path/to/dbus-proxy]
+
+import os
+import sys
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "tests"))
+
+import proxytest
+
+SIZES = [64, 1024, 16 * 1024, 256 * 1024, 1024 * 1024, 8 * 1024 * 1024]
+BYTES_PER_SIZE = 256 * 1024 * 1024
+ENGINES = [("vtable", []), ("message", ["--message-forwarding"])]
+
+
+def main():
+    service = proxytest.start_service()
+
+    try:
+        print("%-8s %10s %8s %12s %10s" % ("engine", "payload", "calls", "calls/s", "MB/s"))
+        for engine, options in ENGINES:
+            proxy = proxytest.start_proxy(*options)
+            try:
+                connection = proxytest.private_connection()
+                for size in SIZES:
+                    parameters = proxytest.byte_array_parameters(size)
+                    calls = max(10, min(20000, BYTES_PER_SIZE // size))
+                    proxytest.time_calls(connection, min(calls, 10), "Echo", parameters)
+
+                    started = time.monotonic()
+                    proxytest.time_calls(connection, calls, "Echo", parameters)
+                    elapsed = time.monotonic() - started
+                    print("%-8s %10d %8d %12.0f %10.1f" % (engine, size, calls, calls / elapsed,
+                                                          2 * size * calls / elapsed / (1024 * 1024)))
+            finally:
+                proxy.stop()
+    finally:
+        service.stop()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,46 @@
+#!/usr/bin/env python3
+# Startup time of the proxy for source trees of 10, 1,000 and 10,000
+# objects, with one Introspect call at a time and with the default
+# concurrency. Startup ends when the proxy owns its name; the proxy's own
+# "Startup:" phase timings are printed below each run.
+#
+#   dbus-run-session -- python3 bench/introspection-startup.py [path/to/dbus-proxy]
+
+import os
+import sys
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "tests"))
+
+import proxytest
+
+TREES = [10, 1000, 10000]
+CONCURRENCY = [1, 16]
+RUNS = 3
+
+
+def main():
+    print("%8s %12s %12s" % ("objects", "concurrency", "startup ms"))
+    for objects in TREES:
+        service = proxytest.start_service("--objects", str(objects))
+        try:
+            for concurrency in CONCURRENCY:
+                best = None
+                for _ in range(RUNS):
+                    started = time.monotonic()
+                    proxy = proxytest.start_proxy("--introspect-concurrency", str(concurrency))
+                    elapsed = time.monotonic() - started
+                    proxy.stop()
+                    if best is None or elapsed < best[0]:
+                        best = (elapsed, proxy.output())
+                print("%8d %12d %12.1f" % (objects, concurrency, best[0] * 1000))
+                for line in best[1]:
+                    if "Startup:" in line:
+                        print("    " + line.split("Startup: ", 1)[1])
+        finally:
+            service.stop()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
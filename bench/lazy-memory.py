@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+# Resident memory and startup time of eager and lazy (--lazy-objects)
+# registration for a 10,000-object source tree, right after startup and
+# after clients have read a property of 1,000 of the objects (more than the
+# lazy mode's default cache of 256).
+#
+#   dbus-run-session -- python3 bench/lazy-memory.py [path/to/dbus-proxy]
+
+import os
+import random
+import sys
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "tests"))
+
+from gi.repository import GLib
+
+import proxytest
+
+OBJECTS = 10000
+TOUCHED = 1000
+MODES = [("eager", []), ("lazy", ["--lazy-objects"])]
+
+
+def main():
+    service = proxytest.start_service("--objects", str(OBJECTS))
+
+    try:
+        print("%-6s %12s %14s %14s" % ("mode", "startup ms", "RSS KiB", "touched KiB"))
+        for mode, options in MODES:
+            started = time.monotonic()
+            proxy = proxytest.start_proxy(*options)
+            startup = time.monotonic() - started
+            try:
+                rss = proxytest.rss_kib(proxy.pid)
+                connection = proxytest.private_connection()
+                for i in random.Random(1).sample(range(OBJECTS), TOUCHED):
+                    path = "%s/group%d/item%d" % (proxytest.SERVICE_PATH, i // 100, i)
+                    proxytest.time_calls(connection, 1, "Get",
+                                         GLib.Variant("(ss)", (proxytest.SERVICE_INTERFACE + ".Item", "Index")),
+                                         interface="org.freedesktop.DBus.Properties", path=path)
+                touched = proxytest.rss_kib(proxy.pid)
+            finally:
+                proxy.stop()
+            print("%-6s %12.1f %14d %14d" % (mode, startup * 1000, rss, touched))
+    finally:
+        service.stop()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+# Small-call latency through the proxy while other clients move 8 MB echoes
+# through it, with all calls on the shared source connection, spread over a
+# pool of private ones, and with the echoes on a bulk lane of their own.
+# The proxy's per-lane queue-depth counters are printed after each run.
+#
+#   dbus-run-session -- python3 bench/pool-latency.py [path/to/dbus-proxy]
+
+import os
+import sys
+import threading
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "tests"))
+
+from gi.repository import GLib
+
+import proxytest
+
+CALLS = 2000
+BULK_CLIENTS = 2
+BULK_SIZE = 8 * 1024 * 1024
+CONFIGS = [
+    ("shared", []),
+    ("pool of 4", ["--source-pool-size", "4"]),
+    ("pool of 4 + bulk lane", ["--source-pool-size", "4",
+                               "--bulk-method", proxytest.SERVICE_INTERFACE + ".Echo"]),
+]
+
+
+def bulk_client(stop):
+    connection = proxytest.private_connection()
+    parameters = proxytest.byte_array_parameters(BULK_SIZE)
+    while not stop.is_set():
+        proxytest.time_calls(connection, 1, "Echo", parameters)
+
+
+def main():
+    service = proxytest.start_service()
+
+    try:
+        for label, options in CONFIGS:
+            proxy = proxytest.start_proxy(*options)
+            stop = threading.Event()
+            clients = [threading.Thread(target=bulk_client, args=(stop,), daemon=True)
+                       for _ in range(BULK_CLIENTS)]
+            try:
+                connection = proxytest.private_connection()
+                sleep = GLib.Variant("(u)", (0,))
+                proxytest.time_calls(connection, 100, "Sleep", sleep)
+                for client in clients:
+                    client.start()
+                proxytest.report_latency(label, proxytest.time_calls(connection, CALLS, "Sleep", sleep))
+            finally:
+                stop.set()
+                for client in clients:
+                    client.join()
+                proxy.stop()
+            for line in proxy.output():
+                if "Stats: source lane" in line or "Stats: bulk lane" in line:
+                    print("    " + line.split("Stats: ", 1)[1])
+    finally:
+        service.stop()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
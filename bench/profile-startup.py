@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+# Startup time and per-call latency with runtime introspection and with a
+# compiled-in profile (--profile) of the test service exporting 1,000
+# objects, for the vtable and the message-level engine. The proxy's
+# profile call counter, logged on shutdown, is printed after each profile
+# run; it counts the calls forwarded with a precomputed reply type.
+#
+# The profile is built from profiles/slow-service.xml. Without it, the
+# script writes it from the running test service and stops: rebuild with
+# make, run again, and delete the file afterwards.
+#
+#   dbus-run-session -- python3 bench/profile-startup.py [path/to/dbus-proxy]
+
+import os
+import sys
+import time
+import xml.etree.ElementTree as ElementTree
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "tests"))
+
+from gi.repository import Gio, GLib
+
+import proxytest
+
+OBJECTS = 1000
+PROFILE = "slow-service"
+PROFILE_XML = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "profiles", PROFILE + ".xml")
+RUNS = 3
+CALLS = 5000
+MODES = [("introspected", []), ("profile", ["--profile", PROFILE])]
+ENGINES = [("vtable", []), ("message", ["--message-forwarding"])]
+
+
+# Introspection XML of path with all child objects inlined
+def introspect_tree(bus, path):
+    xml = bus.call_sync(proxytest.SERVICE_NAME, path, "org.freedesktop.DBus.Introspectable", "Introspect",
+                        None, GLib.VariantType.new("(s)"), Gio.DBusCallFlags.NONE, -1, None).unpack()[0]
+    node = ElementTree.fromstring(xml)
+    for index, child in enumerate(list(node)):
+        if child.tag != "node" or "name" not in child.attrib:
+            continue
+        name = child.attrib["name"]
+        inlined = introspect_tree(bus, path.rstrip("/") + "/" + name)
+        inlined.attrib["name"] = name
+        node.remove(child)
+        node.insert(index, inlined)
+    return node
+
+
+def write_profile():
+    root = introspect_tree(proxytest.session_bus(), proxytest.SERVICE_PATH)
+    root.attrib["name"] = proxytest.SERVICE_PATH
+    ElementTree.ElementTree(root).write(PROFILE_XML, encoding="unicode")
+
+
+def main():
+    service = proxytest.start_service("--objects", str(OBJECTS))
+
+    try:
+        if not os.path.exists(PROFILE_XML):
+            write_profile()
+            print("Wrote %s; rebuild dbus-proxy with make and run again" % os.path.normpath(PROFILE_XML))
+            return 1
+
+        print("%-14s %12s" % ("discovery", "startup ms"))
+        for mode, options in MODES:
+            best = None
+            for _ in range(RUNS):
+                started = time.monotonic()
+                proxy = proxytest.start_proxy(*options)
+                elapsed = time.monotonic() - started
+                proxy.stop()
+                best = elapsed if best is None else min(best, elapsed)
+            print("%-14s %12.1f" % (mode, best * 1000))
+
+        sleep = GLib.Variant("(u)", (0,))
+        for engine, engine_options in ENGINES:
+            for mode, options in MODES:
+                proxy = proxytest.start_proxy(*(options + engine_options))
+                try:
+                    connection = proxytest.private_connection()
+                    proxytest.time_calls(connection, 100, "Sleep", sleep)
+                    proxytest.report_latency("%s, %s" % (engine, mode),
+                                             proxytest.time_calls(connection, CALLS, "Sleep", sleep))
+                finally:
+                    proxy.stop()
+                for line in proxy.output():
+                    if "Stats: profile" in line:
+                        print("    " + line.split("Stats: ", 1)[1])
+    finally:
+        service.stop()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+# Latency of unrelated calls through the proxy while property reads of the
+# source are slow. A blocking Properties path stalls everything behind each
+# slow Get, which shows as a p99 close to the source's delay; an asynchronous
+# one leaves the percentiles where they are without the slow reads.
+#
+#   dbus-run-session -- python3 bench/property-latency.py [path/to/dbus-proxy]
+
+import os
+import sys
+import threading
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "tests"))
+
+from gi.repository import Gio, GLib
+
+import proxytest
+
+CALLS = 2000
+SLOW_READERS = 4
+SLOW_MS = 2000
+
+
+def slow_reader(stop):
+    connection = proxytest.private_connection()
+    while not stop.is_set():
+        connection.call_sync(proxytest.PROXY_NAME, proxytest.SERVICE_PATH, "org.freedesktop.DBus.Properties",
+                             "Get", GLib.Variant("(ss)", (proxytest.SERVICE_INTERFACE, "SlowValue")), None,
+                             Gio.DBusCallFlags.NONE, -1, None)
+
+
+def main():
+    service = proxytest.start_service()
+    # Reads must reach the source rather than the property cache
+    proxy = proxytest.start_proxy("--no-property-cache")
+    stop = threading.Event()
+    readers = []
+
+    try:
+        connection = proxytest.private_connection()
+        sleep = GLib.Variant("(u)", (0,))
+        proxytest.time_calls(connection, 100, "Sleep", sleep)
+        proxytest.report_latency("idle", proxytest.time_calls(connection, CALLS, "Sleep", sleep))
+
+        proxytest.set_service_delay(SLOW_MS)
+        for _ in range(SLOW_READERS):
+            reader = threading.Thread(target=slow_reader, args=(stop,), daemon=True)
+            reader.start()
+            readers.append(reader)
+        proxytest.report_latency("%d slow reads in flight" % SLOW_READERS,
+                                 proxytest.time_calls(connection, CALLS, "Sleep", sleep))
+    finally:
+        stop.set()
+        proxytest.set_service_delay(0)
+        for reader in readers:
+            reader.join(timeout=SLOW_MS / 1000.0 * 2)
+        proxy.stop()
+        service.stop()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
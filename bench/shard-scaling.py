@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+# Call throughput through the proxy with 0 (everything on the main loop) to
+# 8 worker shards. Clients run in separate processes so the client side is
+# not the bottleneck; use at least as many as the largest shard count. The
+# test service is single-threaded Python, so its own rate, called directly,
+# is printed first: shard counts that reach it are bounded by the service,
+# not by the proxy.
+#
+#   dbus-run-session -- python3 bench/shard-scaling.py [path/to/dbus-proxy]
+
+import multiprocessing
+import os
+import sys
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "tests"))
+
+from gi.repository import GLib
+
+import proxytest
+
+SHARDS = [0, 1, 2, 4, 8]
+CLIENTS = 16
+DURATION = 10.0
+
+
+def client(destination, start, results):
+    connection = proxytest.private_connection()
+    sleep = GLib.Variant("(u)", (0,))
+    proxytest.time_calls(connection, 100, "Sleep", sleep, destination=destination)
+    start.wait()
+    calls = 0
+    deadline = time.monotonic() + DURATION
+    while time.monotonic() < deadline:
+        proxytest.time_calls(connection, 100, "Sleep", sleep, destination=destination)
+        calls += 100
+    results.put(calls)
+
+
+# Calls per second of CLIENTS processes calling destination for DURATION
+def call_rate(context, destination):
+    start = context.Event()
+    results = context.Queue()
+    clients = [context.Process(target=client, args=(destination, start, results)) for _ in range(CLIENTS)]
+    for process in clients:
+        process.start()
+    start.set()
+    total = sum(results.get() for _ in clients)
+    for process in clients:
+        process.join()
+    return total / DURATION
+
+
+def main():
+    context = multiprocessing.get_context("spawn")
+    service = proxytest.start_service()
+
+    try:
+        print("%-7s %12.0f" % ("direct", call_rate(context, proxytest.SERVICE_NAME)))
+        print("%-7s %12s %10s" % ("shards", "calls/s", "speedup"))
+        baseline = None
+        for shards in SHARDS:
+            proxy = proxytest.start_proxy("--shards", str(shards))
+            try:
+                rate = call_rate(context, proxytest.PROXY_NAME)
+            finally:
+                proxy.stop()
+            baseline = baseline or rate
+            print("%-7d %12.0f %9.2fx" % (shards, rate, rate / baseline))
+    finally:
+        service.stop()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
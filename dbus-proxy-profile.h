@@ -0,0 +1,40 @@
+// Ahead-of-time proxy profiles.
+//
+// A profile is the introspection data of a fixed source service compiled
+// into dbus-proxy, generated from introspection XML by dbus-proxy-profilegen.
+// Loading one replaces the runtime Introspect walk and XML parsing: the
+// GDBus info structures are static (ref_count -1) and are registered as-is.
+
+#pragma once
+
+#include <gio/gio.h>
+
+// Method info with the data the proxy needs per call. The GDBusMethodInfo
+// comes first, so the pointer GDBus hands to the vtable can be cast back.
+typedef struct {
+    GDBusMethodInfo parent;
+    guint id;                 // Index of the method within its profile
+    const char *in_type;      // GVariant type of the in args, e.g. "(su)"
+    const char *out_type;     // GVariant type of the reply
+} ProxyProfileMethodInfo;
+
+// One object of the source service and its interfaces (NULL-terminated)
+typedef struct {
+    const char *object_path;
+    GDBusInterfaceInfo *const *interfaces;
+} ProxyProfileObject;
+
+typedef struct {
+    const char *name;                 // Selected with --profile
+    const char *source_object_path;   // Root the objects were generated under
+    const ProxyProfileObject *objects;
+    guint n_objects;
+    guint n_methods;                  // ProxyProfileMethodInfo ids are below this
+} ProxyProfile;
+
+// The profile data of a method GDBus hands to the proxy, or NULL for one
+// parsed at runtime: only profile infos are static
+static inline const ProxyProfileMethodInfo *proxy_profile_method(const GDBusMethodInfo *info)
+{
+    return info && info->ref_count == -1 ? (const ProxyProfileMethodInfo *)info : NULL;
+}
@@ -0,0 +1,302 @@
+// dbus-proxy-profilegen: turn introspection XML into a compiled-in proxy profile
+//
+// Usage: dbus-proxy-profilegen NAME INTROSPECTION.xml [OBJECT_PATH] > NAME.profile.h
+//
+// The XML describes OBJECT_PATH (default: the name attribute of the root
+// <node>), with child objects inlined as nested <node> elements (child nodes
+// without content are skipped). The output defines
+// static GDBus info tables, one constexpr ID per method and a ProxyProfile
+// named proxy_profile_NAME; see dbus-proxy-profile.h.
+
+#include <gio/gio.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    GString *out;
+    const char *prefix;        // "profile_<name>"
+    GHashTable *interfaces;    // Interface name -> emitted identifier
+    GPtrArray *objects;        // Object paths, in output order
+    GPtrArray *object_ifaces;  // Per object: GPtrArray of interface identifiers
+    guint n_methods;
+} Generator;
+
+// C identifier for a D-Bus name
+static gchar *identifier(const char *name)
+{
+    gchar *id = g_strdup(name);
+    for (gchar *p = id; *p; p++) {
+        if (!g_ascii_isalnum(*p)) *p = '_';
+    }
+    return id;
+}
+
+// GVariant tuple type of an argument list
+static gchar *args_type(GDBusArgInfo **args)
+{
+    GString *type = g_string_new("(");
+    for (int i = 0; args && args[i]; i++) {
+        g_string_append(type, args[i]->signature);
+    }
+    g_string_append_c(type, ')');
+    return g_string_free(type, FALSE);
+}
+
+// Emit a NULL-terminated annotation table; returns the expression to reference it
+static gchar *emit_annotations(Generator *gen, const char *id, GDBusAnnotationInfo **annotations)
+{
+    if (!annotations || !annotations[0]) return g_strdup("NULL");
+
+    for (int i = 0; annotations[i]; i++) {
+        gchar *value = g_strescape(annotations[i]->value, NULL);
+        g_string_append_printf(gen->out,
+                               "static const GDBusAnnotationInfo %s_annotation%d = { -1, (gchar *)\"%s\", (gchar *)\"%s\", NULL };\n",
+                               id, i, annotations[i]->key, value);
+        g_free(value);
+    }
+    g_string_append_printf(gen->out, "static const GDBusAnnotationInfo *const %s_annotations[] = { ", id);
+    for (int i = 0; annotations[i]; i++) {
+        g_string_append_printf(gen->out, "&%s_annotation%d, ", id, i);
+    }
+    g_string_append(gen->out, "NULL };\n");
+    return g_strdup_printf("(GDBusAnnotationInfo **)%s_annotations", id);
+}
+
+// Emit a NULL-terminated argument table; returns the expression to reference it
+static gchar *emit_args(Generator *gen, const char *id, GDBusArgInfo **args)
+{
+    if (!args || !args[0]) return g_strdup("NULL");
+
+    for (int i = 0; args[i]; i++) {
+        g_string_append_printf(gen->out,
+                               "static const GDBusArgInfo %s_arg%d = { -1, (gchar *)\"%s\", (gchar *)\"%s\", NULL };\n",
+                               id, i, args[i]->name ? args[i]->name : "", args[i]->signature);
+    }
+    g_string_append_printf(gen->out, "static const GDBusArgInfo *const %s_args[] = { ", id);
+    for (int i = 0; args[i]; i++) {
+        g_string_append_printf(gen->out, "&%s_arg%d, ", id, i);
+    }
+    g_string_append(gen->out, "NULL };\n");
+    return g_strdup_printf("(GDBusArgInfo **)%s_args", id);
+}
+
+// Emit the info tables of one interface, once per interface name
+static const char *emit_interface(Generator *gen, GDBusInterfaceInfo *iface)
+{
+    const char *existing = (const char *)g_hash_table_lookup(gen->interfaces, iface->name);
+    if (existing) return existing;
+
+    gchar *name_id = identifier(iface->name);
+    gchar *id = g_strdup_printf("%s_%s", gen->prefix, name_id);
+    g_string_append_printf(gen->out, "\n// %s\n", iface->name);
+
+    GString *methods = g_string_new(NULL);
+    for (int i = 0; iface->methods && iface->methods[i]; i++) {
+        GDBusMethodInfo *method = iface->methods[i];
+        gchar *method_id = g_strdup_printf("%s_%s", id, method->name);
+        gchar *in_id = g_strdup_printf("%s_in", method_id);
+        gchar *out_id = g_strdup_printf("%s_out", method_id);
+        gchar *in_args = emit_args(gen, in_id, method->in_args);
+        gchar *out_args = emit_args(gen, out_id, method->out_args);
+        gchar *annotations = emit_annotations(gen, method_id, method->annotations);
+        gchar *in_type = args_type(method->in_args);
+        gchar *out_type = args_type(method->out_args);
+
+        g_string_append_printf(gen->out, "static constexpr guint %s_member_%s_%s = %u;\n",
+                               gen->prefix, name_id, method->name, gen->n_methods);
+        g_string_append_printf(gen->out,
+                               "static const ProxyProfileMethodInfo %s = {\n"
+                               "    { -1, (gchar *)\"%s\", %s, %s, %s },\n"
+                               "    %s_member_%s_%s, \"%s\", \"%s\"\n"
+                               "};\n",
+                               method_id, method->name, in_args, out_args, annotations,
+                               gen->prefix, name_id, method->name, in_type, out_type);
+        g_string_append_printf(methods, "(const GDBusMethodInfo *)&%s, ", method_id);
+        gen->n_methods++;
+
+        g_free(out_type);
+        g_free(in_type);
+        g_free(annotations);
+        g_free(out_args);
+        g_free(in_args);
+        g_free(out_id);
+        g_free(in_id);
+        g_free(method_id);
+    }
+
+    GString *signals = g_string_new(NULL);
+    for (int i = 0; iface->signals && iface->signals[i]; i++) {
+        GDBusSignalInfo *signal = iface->signals[i];
+        gchar *signal_id = g_strdup_printf("%s_signal_%s", id, signal->name);
+        gchar *args = emit_args(gen, signal_id, signal->args);
+        gchar *annotations = emit_annotations(gen, signal_id, signal->annotations);
+
+        g_string_append_printf(gen->out, "static const GDBusSignalInfo %s = { -1, (gchar *)\"%s\", %s, %s };\n",
+                               signal_id, signal->name, args, annotations);
+        g_string_append_printf(signals, "&%s, ", signal_id);
+
+        g_free(annotations);
+        g_free(args);
+        g_free(signal_id);
+    }
+
+    GString *properties = g_string_new(NULL);
+    for (int i = 0; iface->properties && iface->properties[i]; i++) {
+        GDBusPropertyInfo *property = iface->properties[i];
+        gchar *property_id = g_strdup_printf("%s_property_%s", id, property->name);
+        gchar *annotations = emit_annotations(gen, property_id, property->annotations);
+
+        g_string_append_printf(gen->out,
+                               "static const GDBusPropertyInfo %s = { -1, (gchar *)\"%s\", (gchar *)\"%s\", "
+                               "(GDBusPropertyInfoFlags)%d, %s };\n",
+                               property_id, property->name, property->signature, (int)property->flags, annotations);
+        g_string_append_printf(properties, "&%s, ", property_id);
+
+        g_free(annotations);
+        g_free(property_id);
+    }
+
+    g_string_append_printf(gen->out, "static const GDBusMethodInfo *const %s_methods[] = { %sNULL };\n",
+                           id, methods->str);
+    g_string_append_printf(gen->out, "static const GDBusSignalInfo *const %s_signals[] = { %sNULL };\n",
+                           id, signals->str);
+    g_string_append_printf(gen->out, "static const GDBusPropertyInfo *const %s_properties[] = { %sNULL };\n",
+                           id, properties->str);
+    gchar *annotations = emit_annotations(gen, id, iface->annotations);
+    g_string_append_printf(gen->out,
+                           "static const GDBusInterfaceInfo %s = {\n"
+                           "    -1, (gchar *)\"%s\",\n"
+                           "    (GDBusMethodInfo **)%s_methods,\n"
+                           "    (GDBusSignalInfo **)%s_signals,\n"
+                           "    (GDBusPropertyInfo **)%s_properties,\n"
+                           "    %s\n"
+                           "};\n",
+                           id, iface->name, id, id, id, annotations);
+
+    g_free(annotations);
+    g_string_free(properties, TRUE);
+    g_string_free(signals, TRUE);
+    g_string_free(methods, TRUE);
+    g_free(name_id);
+
+    g_hash_table_insert(gen->interfaces, g_strdup(iface->name), id);
+    return id;
+}
+
+// Emit the interfaces of an object and recurse into inlined children
+static void emit_node(Generator *gen, const char *object_path, GDBusNodeInfo *node)
+{
+    if (node->interfaces && node->interfaces[0]) {
+        GPtrArray *ids = g_ptr_array_new();
+        for (int i = 0; node->interfaces[i]; i++) {
+            g_ptr_array_add(ids, (gpointer)emit_interface(gen, node->interfaces[i]));
+        }
+        g_ptr_array_add(gen->objects, g_strdup(object_path));
+        g_ptr_array_add(gen->object_ifaces, ids);
+    }
+
+    for (int i = 0; node->nodes && node->nodes[i]; i++) {
+        GDBusNodeInfo *child = node->nodes[i];
+        if (!child->path) continue;
+
+        gchar *child_path = child->path[0] == '/' ? g_strdup(child->path)
+                          : g_strcmp0(object_path, "/") == 0 ? g_strconcat("/", child->path, NULL)
+                          : g_strconcat(object_path, "/", child->path, NULL);
+        if ((!child->interfaces || !child->interfaces[0]) && (!child->nodes || !child->nodes[0])) {
+            g_printerr("Skipping %s: no inlined introspection data\n", child_path);
+        } else {
+            emit_node(gen, child_path, child);
+        }
+        g_free(child_path);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    GError *error = NULL;
+    gchar *xml = NULL;
+
+    if (argc != 3 && argc != 4) {
+        g_printerr("Usage: %s NAME INTROSPECTION.xml [OBJECT_PATH]\n", argv[0]);
+        return 1;
+    }
+
+    const char *name = argv[1];
+    const char *xml_file = argv[2];
+
+    if (!g_file_get_contents(xml_file, &xml, NULL, &error)) {
+        g_printerr("Failed to read %s: %s\n", xml_file, error->message);
+        g_error_free(error);
+        return 1;
+    }
+
+    GDBusNodeInfo *root = g_dbus_node_info_new_for_xml(xml, &error);
+    g_free(xml);
+    if (!root) {
+        g_printerr("Failed to parse %s: %s\n", xml_file, error->message);
+        g_error_free(error);
+        return 1;
+    }
+
+    const char *object_path = argc == 4 ? argv[3] : root->path;
+    if (!object_path || !g_variant_is_object_path(object_path)) {
+        g_printerr("Invalid or missing object path for %s: %s\n", xml_file, object_path ? object_path : "(none)");
+        g_dbus_node_info_unref(root);
+        return 1;
+    }
+
+    gchar *name_id = identifier(name);
+    Generator gen = {};
+    gen.out = g_string_new(NULL);
+    gen.prefix = g_strdup_printf("profile_%s", name_id);
+    gen.interfaces = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    gen.objects = g_ptr_array_new_with_free_func(g_free);
+    gen.object_ifaces = g_ptr_array_new_with_free_func((GDestroyNotify)g_ptr_array_unref);
+
+    g_string_append_printf(gen.out,
+                           "// Generated by dbus-proxy-profilegen from %s. Do not edit.\n\n"
+                           "#pragma once\n\n"
+                           "#include \"dbus-proxy-profile.h\"\n",
+                           xml_file);
+
+    emit_node(&gen, object_path, root);
+
+    g_string_append(gen.out, "\n");
+    for (guint i = 0; i < gen.objects->len; i++) {
+        GPtrArray *ids = (GPtrArray *)g_ptr_array_index(gen.object_ifaces, i);
+        g_string_append_printf(gen.out, "static GDBusInterfaceInfo *const %s_object%u_interfaces[] = { ",
+                               gen.prefix, i);
+        for (guint j = 0; j < ids->len; j++) {
+            g_string_append_printf(gen.out, "(GDBusInterfaceInfo *)&%s, ", (const char *)g_ptr_array_index(ids, j));
+        }
+        g_string_append(gen.out, "NULL };\n");
+    }
+
+    g_string_append_printf(gen.out, "\nstatic const ProxyProfileObject %s_objects[] = {\n", gen.prefix);
+    for (guint i = 0; i < gen.objects->len; i++) {
+        g_string_append_printf(gen.out, "    { \"%s\", %s_object%u_interfaces },\n",
+                               (const char *)g_ptr_array_index(gen.objects, i), gen.prefix, i);
+    }
+    g_string_append(gen.out, "};\n");
+
+    g_string_append_printf(gen.out,
+                           "\nstatic const ProxyProfile proxy_%s = {\n"
+                           "    \"%s\", \"%s\",\n"
+                           "    %s_objects, %u,\n"
+                           "    %u\n"
+                           "};\n",
+                           gen.prefix, name, object_path, gen.prefix, gen.objects->len, gen.n_methods);
+
+    fputs(gen.out->str, stdout);
+    g_printerr("Profile %s: %u object(s), %u interface(s), %u method(s)\n",
+               name, gen.objects->len, g_hash_table_size(gen.interfaces), gen.n_methods);
+
+    g_ptr_array_unref(gen.object_ifaces);
+    g_ptr_array_unref(gen.objects);
+    g_hash_table_destroy(gen.interfaces);
+    g_free((gchar *)gen.prefix);
+    g_string_free(gen.out, TRUE);
+    g_free(name_id);
+    g_dbus_node_info_unref(root);
+    return 0;
+}
@@ -9,11 +9,50 @@
  */
 
 #include <gio/gio.h>
+#include <gio/gunixfdlist.h>
 #include <glib/gprintf.h>
+#include <glib-unix.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "dbus-proxy-profile.h"
+
+// Profiles generated from profiles/*.xml by the Makefile
+#if __has_include("dbus-proxy-profiles.inc")
+#include "dbus-proxy-profiles.inc"
+#else
+static const ProxyProfile *const proxy_profiles[] = { NULL };
+#endif
+
+// What to do with forwarded signals once the outgoing queue is over budget
+typedef enum {
+    SIGNAL_QUEUE_BLOCK,        // Stall the loop until the target bus drains
+    SIGNAL_QUEUE_DROP_OLDEST,  // Discard the oldest queued signals
+    SIGNAL_QUEUE_COALESCE      // Merge PropertiesChanged into a queued one, else drop the oldest
+} SignalQueuePolicy;
+
+// Priority classes of forwarded calls and signals, highest first
+typedef enum {
+    PRIORITY_INTERACTIVE,
+    PRIORITY_NORMAL,       // Unmatched calls and signals
+    PRIORITY_BACKGROUND,
+    PRIORITY_CLASSES
+} PriorityClass;
+
+// What a --priority rule matches on
+typedef enum {
+    PRIORITY_MATCH_INTERFACE,
+    PRIORITY_MATCH_MEMBER,   // Method or signal name
+    PRIORITY_MATCH_SENDER    // Target client, by well-known or unique name (calls only)
+} PriorityMatch;
+
+typedef struct {
+    PriorityMatch match;
+    const char *name;
+    PriorityClass priority;
+} PriorityRule;
+
 // Configuration structure
 typedef struct {
     const char *source_bus_name;
@@ -22,20 +61,359 @@ typedef struct {
     GBusType source_bus_type;
     GBusType target_bus_type;
     gboolean verbose;
+    gboolean property_cache;    // Serve Properties.Get from the local cache
+    gboolean message_forwarding; // Relay method calls as GDBusMessages instead of via the vtable
+    guint source_pool_size;     // Private source connections for forwarded calls, 0 = shared bus
+    GPtrArray *bulk_methods;    // "interface.method" names routed to the bulk lane
+    guint shards;               // Worker threads for forwarding and emission, 0 = main loop only
+    GHashTable *coalesce_windows; // Interface name -> PropertiesChanged coalescing window (ms)
+    guint signal_queue_messages; // Outgoing signal queue budget in messages, 0 = emit directly
+    gsize signal_queue_bytes;    // Outgoing signal queue budget in body bytes, 0 = unlimited
+    SignalQueuePolicy signal_queue_policy;
+    guint introspect_depth;     // Levels below source_object_path to discover, 0 = root only, G_MAXUINT = all
+    guint introspect_concurrency; // Introspect calls in flight during discovery
+    gboolean lazy_objects;      // Serve the subtree through register_subtree instead of per-object registration
+    guint object_cache_size;    // Per-object introspection data kept by the lazy mode (LRU)
+    gboolean object_manager;    // Mirror through the source's ObjectManager when it has one
+    const char *introspection_cache_dir; // On-disk introspection cache, NULL disables
+    const ProxyProfile *profile; // Compiled-in introspection data used instead of Introspect
+    guint max_in_flight;        // Upper bound of the adaptive in-flight limit toward the source, 0 = no limit
+    guint admission_queue;      // Calls waiting for an in-flight slot before new ones are rejected
+    guint latency_target_ms;    // Replies slower than this shrink the in-flight limit
+    GHashTable *sender_weights; // Well-known or unique name -> fair queueing weight (default 1)
+    GPtrArray *priority_rules;  // PriorityRule, first match wins
+    guint priority_starvation;  // Higher-class picks before a waiting lower class is served, 0 = strict
+    gint call_timeout_ms;       // Timeout of forwarded calls, -1 = GDBus default (25 s)
+    GHashTable *method_timeouts; // "interface.method" or interface name -> timeout (ms), overrides call_timeout_ms
+    guint hold_messages;        // Calls held while the source name is unowned, 0 = fail them right away
+    gsize hold_bytes;           // Body bytes of held calls, 0 = unlimited
+    guint hold_timeout_ms;      // Longest a call is held before it fails
+    guint breaker_error_rate;   // Percentage of failed calls that opens the circuit breaker, 0 = off
+    guint breaker_latency_ms;   // Mean reply latency that opens the circuit breaker, 0 = off
+    guint breaker_window_ms;    // Window the error rate and mean latency are measured over
+    guint breaker_min_calls;    // Calls in a window before it can trip
+    guint breaker_cooldown_ms;  // Time open before probing the source
+    guint breaker_probes;       // Calls let through half-open; all must succeed to close
+    guint stats_interval;       // Seconds between stats reports, 0 disables
 } ProxyConfig;
 
+// Latency histogram buckets: four per power of two microseconds, see
+// latency_bucket()
+#define LATENCY_BUCKETS 128
+
+// Runtime counters, reported by log_stats()
+typedef struct {
+    guint64 property_cache_hits;
+    guint64 property_cache_misses;
+    guint64 getall_forwarded;        // GetAll calls forwarded as a single upstream GetAll
+    guint64 getall_calls_saved;      // Per-property Gets those GetAlls would have cost
+    guint64 message_calls_forwarded; // Calls relayed by the message-level engine
+    guint64 fds_forwarded;           // Unix fds passed through in calls, replies and signals
+    guint64 one_way_calls;           // NO_REPLY_EXPECTED calls forwarded without reply tracking
+    guint64 properties_changed_merged;  // PropertiesChanged folded into a pending one
+    guint64 properties_changed_flushed; // Combined PropertiesChanged emitted after a window
+    guint64 coalesce_max_delay_us;      // Longest delay a coalesced signal was held
+    guint64 signals_emitted;            // Signals handed to the target bus from the queue
+    guint64 signals_dropped;            // Signals discarded by the drop-oldest policy
+    guint64 signals_coalesced;          // PropertiesChanged merged into a queued one
+    guint64 signal_queue_blocked;       // Times the block policy waited for the target bus
+    guint64 signal_queue_max_depth;     // High-water mark of queued signals
+    guint64 signal_latency_total_us;    // Sum of enqueue-to-emit delays
+    guint64 signal_latency_max_us;      // Longest enqueue-to-emit delay
+    guint64 object_cache_hits;          // Lazy mode introspection data served from the LRU
+    guint64 object_cache_misses;        // Lazy mode introspection data fetched from the source
+    guint64 object_cache_evictions;
+    guint64 managed_objects_served;     // GetManagedObjects answered from local state
+    guint64 interfaces_added;           // Interfaces mirrored from InterfacesAdded
+    guint64 interfaces_removed;         // Interfaces dropped on InterfacesRemoved
+    guint64 profile_calls;              // Calls forwarded with a profile's precomputed reply type
+    guint64 source_restarts;            // New owners of the source name after startup
+    guint64 resync_interfaces_changed;  // Interfaces re-registered or removed by those resyncs
+    guint64 admission_queued;           // Calls that waited for an in-flight slot
+    guint64 admission_rejected;         // Calls rejected with LimitsExceeded, admission queue full
+    guint64 admission_wait_total_us;    // Time queued calls spent waiting for a slot
+    guint64 calls_cancelled;            // Forwarded calls abandoned because their caller left the target bus
+    guint64 calls_timed_out;            // Forwarded calls that hit their timeout
+    guint64 calls_parked;               // Calls held during a source outage
+    guint64 parked_replayed;            // Held calls forwarded once the source returned
+    guint64 parked_expired;             // Held calls failed after hold_timeout_ms
+    guint64 parked_rejected;            // Calls failed because the hold queue was full
+    guint64 parked_max_depth;
+    guint64 park_time_total_us;         // Sum of hold times of replayed and expired calls
+    guint64 park_time_max_us;
+    guint64 breaker_rejected;           // Calls failed fast while the circuit breaker was open
+    guint64 call_latency[PRIORITY_CLASSES][LATENCY_BUCKETS];   // Arrival-to-reply of forwarded calls
+    guint64 signal_latency[PRIORITY_CLASSES][LATENCY_BUCKETS]; // Enqueue-to-emit of queued signals
+} ProxyStats;
+
+// A connection to the source bus used for forwarded calls
+typedef struct {
+    GDBusConnection *connection;
+    guint in_flight;       // Calls awaiting a reply
+    guint max_in_flight;   // High-water mark of in_flight
+    guint64 calls;         // Calls dispatched on this lane
+} SourceLane;
+
+// Forwarded signals waiting for the target bus. Only a small batch is handed
+// to GDBus at a time; the next batch follows once the previous one has been
+// written out, so slow target buses back up here, under a budget, rather
+// than in GDBus' unbounded outgoing buffer.
+typedef struct {
+    GQueue queues[PRIORITY_CLASSES]; // SignalEmission per priority class, oldest first
+    guint length;          // Signals in all classes
+    guint passed_over[PRIORITY_CLASSES]; // Batches a waiting class was skipped for a higher one
+    gsize bytes;           // Body bytes of the queued signals
+    GHashTable *by_key;    // "path interface member arg0" -> newest queued PropertiesChanged (coalesce policy)
+    gboolean flushing;     // A batch is being written to the target bus
+} SignalQueue;
+
+// A worker thread with its own main context and source connection. Method
+// calls are sharded by sender and signal emission by object path, so per-client
+// and per-object ordering hold. Everything in a shard, including its lane and
+// counters, is only touched from the shard's own thread.
+typedef struct {
+    guint index;
+    GThread *thread;
+    GMainContext *context;
+    GMainLoop *loop;
+    SourceLane *lane;
+    SignalQueue signal_queue;
+    ProxyStats stats;
+} ProxyShard;
+
+// PropertiesChanged for one interface on one object, accumulating until its
+// coalescing window closes
+typedef struct {
+    gchar *object_path;
+    gchar *interface_name;
+    GHashTable *changed;      // property name -> GVariant, last value wins
+    GHashTable *invalidated;  // Set of property names
+    gint64 first_seen;        // Monotonic time the window opened
+    guint timeout_id;
+} PendingPropertiesChanged;
+
+// Cached property values of one interface on one object
+typedef struct {
+    GHashTable *values;   // property name -> GVariant
+    guint64 generation;   // Bumped on every PropertiesChanged, guards stale fills
+} PropertyCacheEntry;
+
+// One forwarded source signal, keyed "path interface member" in
+// signal_subscriptions. Every source signal resolves to at most one entry,
+// so it is emitted on the target bus at most once however many interfaces
+// declare it.
+typedef struct {
+    gchar *object_path;
+    gchar *interface_name;
+    gchar *signal_name;
+    guint64 forwarded;    // Signals relayed to the target bus
+} SignalSubscription;
+
+// Introspection data of one object, held by the lazy mode's LRU
+typedef struct {
+    gchar *object_path;
+    GDBusNodeInfo *node;
+} ObjectInfoCacheEntry;
+
+// Forwarded calls of one target caller awaiting a reply. They share a
+// cancellable, fired when the caller leaves the target bus.
+typedef struct {
+    GCancellable *cancellable;
+    guint in_flight;
+} CallerCalls;
+
+typedef enum {
+    BREAKER_CLOSED,     // Calls flow, outcomes are measured
+    BREAKER_OPEN,       // Calls fail fast until breaker_cooldown_ms has passed
+    BREAKER_HALF_OPEN   // breaker_probes calls test the source
+} BreakerState;
+
+// Circuit breaker toward the source: when too many forwarded calls fail,
+// or replies get too slow, calls fail right away instead of piling up
+// behind a source that is not answering. Shared by all shards, so guarded
+// by the breaker lock.
+typedef struct {
+    BreakerState state;
+    gint64 since;              // Monotonic time of the last transition
+    gint64 window_start;       // Closed: outcomes counted since
+    guint window_calls;
+    guint window_failures;
+    gint64 window_latency_us;
+    guint probes;              // Half-open: probes in flight
+    guint probes_passed;
+    guint64 trips;             // Transitions to open
+    guint64 open_total_us;     // Time spent open or half-open, up to since
+} CircuitBreaker;
+
+// What breaker_enter() let a call do
+typedef enum {
+    BREAKER_PASS,
+    BREAKER_PROBE,      // Counts toward closing a half-open breaker
+    BREAKER_REJECT
+} BreakerTicket;
+
+// A call to forward to the source, from its arrival (through the hold
+// queue, shards and admission control) until its reply is relayed
+typedef struct {
+    GDBusMethodInvocation *invocation; // Vtable call, or
+    GDBusMessage *message;             // call taken off the bus by the message-level engine
+    GCancellable *cancellable;         // Of the caller's CallerCalls
+    PriorityClass priority;
+    BreakerTicket breaker;
+    // Profile method of a message-level call, looked up before admission
+    const ProxyProfileMethodInfo *profile_method;
+    gint64 arrived;                    // Monotonic time it reached the proxy, for latency stats
+    gint64 started;                    // Monotonic time it was sent, for the admission controller
+} ForwardedCall;
+
+// Admission control toward the source: at most `limit` forwarded calls are
+// in flight. The limit follows reply latency AIMD-style: it grows by about
+// one per limit's worth of fast replies and is cut by a quarter when a reply
+// is slower than latency_target_ms or times out. Calls over the limit wait
+// in per-sender queues, one per priority class. Classes are served strictly
+// by priority, and within a class senders by deficit round robin so a
+// flooding client only delays itself. Resumed calls run on their own shard.
+// Shared by all shards, so guarded by the admission lock.
+typedef struct {
+    gdouble limit;         // Current in-flight limit, between 1 and max_in_flight
+    guint in_flight;
+    guint waiting;         // Calls in all sender queues
+    GHashTable *senders;   // Unique name -> SenderQueue
+    GQueue active[PRIORITY_CLASSES]; // SenderLane with waiting calls, in round-robin order
+    guint passed_over[PRIORITY_CLASSES]; // Picks a waiting class was skipped for a higher one
+    GHashTable *weights;   // Unique name -> weight, resolved from sender_weights
+    GHashTable *priority_owners; // Unique name -> 1 + index of the first sender rule naming a name it owns
+    gint64 last_decrease;  // Monotonic time of the last cut, one per latency target
+    guint64 decreases;
+} AdmissionControl;
+
+// A call waiting for an in-flight slot
+typedef struct {
+    ProxyShard *shard;                 // Shard the call resumes on, NULL for the main loop
+    ForwardedCall *call;
+    gsize cost;                        // Body bytes plus a fixed per-call cost
+    gint64 queued;
+} AdmissionWaiter;
+
+typedef struct SenderQueue SenderQueue;
+
+// Waiting calls of one sender in one priority class
+typedef struct {
+    SenderQueue *owner;
+    GQueue waiting;        // AdmissionWaiter, oldest first
+    gint64 deficit;        // Bytes it may still send in the current round
+    gboolean active;       // Linked in AdmissionControl.active
+} SenderLane;
+
+// Calls of one target client waiting for admission, and its counters
+struct SenderQueue {
+    gchar *sender;
+    SenderLane lanes[PRIORITY_CLASSES];
+    guint waiting;         // Calls in all lanes
+    guint weight;          // Quanta per round
+    guint64 calls;         // Calls through admission control
+    guint64 bytes;
+    guint64 queued;        // Calls that had to wait
+    guint64 wait_total_us;
+    guint64 wait_max_us;
+};
+
+// A call held while the source name has no owner
+typedef struct {
+    ForwardedCall *forwarded;
+    gsize bytes;                       // Body size, counted against hold_bytes
+    gint64 parked;                     // Monotonic time it was held
+} ParkedCall;
+
+// Phases of the asynchronous startup. Both bus connections open at once;
+// introspection starts as soon as the source bus is up, alongside the private
+// source connections (pool, bulk lane, shards), and registration as soon as
+// introspection is done and the target bus and private connections are up.
+typedef enum {
+    STARTUP_CONNECTING,
+    STARTUP_INTROSPECTING,
+    STARTUP_REGISTERING,
+    STARTUP_ACQUIRING_NAME,
+    STARTUP_READY
+} StartupPhase;
+
+// ObjectManager signal not yet forwarded: an InterfacesAdded whose new
+// interfaces are being introspected, or one queued behind it
+typedef struct {
+    gchar *signal_name;
+    GVariant *parameters;
+} HeldObjectManagerSignal;
+
 // Global state
 typedef struct {
     GDBusConnection *source_bus;
     GDBusConnection *target_bus;
-    GDBusNodeInfo *introspection_data;
-    GHashTable *registered_objects;  // Track registered object IDs
-    GHashTable *signal_subscriptions; // Track signal subscription IDs
+    GHashTable *objects;             // Object path -> GDBusNodeInfo of each discovered object with interfaces
+                                     // (a strv of its interface names in lazy mode, see object_info_cache)
+    GHashTable *object_children;     // Lazy mode: parent path -> GPtrArray of child node names
+    GHashTable *object_info_cache;   // Lazy mode: object path -> GList link in object_info_lru
+    GQueue object_info_lru;          // ObjectInfoCacheEntry, most recently used first
+    GHashTable *registered_subtrees; // Lazy mode: parent path -> subtree registration ID
+    gchar *object_manager_path;      // Source object implementing ObjectManager, NULL if none
+    GQueue object_manager_held;      // HeldObjectManagerSignal, oldest first; the head waits for Introspect
+    GHashTable *introspection_hashes; // Object path -> SHA-256 of its XML, as last written to the cache
+    gboolean started_from_cache;     // Registered from the on-disk cache; revalidate once running
+    StartupPhase startup_phase;
+    guint source_watch_id;           // g_bus_watch_name_on_connection ID for the source name
+    gchar *source_owner;             // Unique name owning the source name, NULL while it has none
+    gboolean source_owner_seen;      // The source has had an owner since the watch started
+    gboolean resyncing;              // Re-introspecting a restarted source
+    gboolean resync_pending;         // Owner changed again (or during startup); resync once possible
+    gint64 resync_started;
+    guint resync_changed;            // Interfaces changed so far by the running resync
+    GHashTable *caller_calls;        // Unique name -> CallerCalls (guarded by the caller_calls lock)
+    GHashTable *name_watches;        // Target bus name -> NameOwnerChanged subscription (caller_calls lock)
+    AdmissionControl admission;      // Guarded by the admission lock
+    gboolean priority_sender_names;  // Some --priority sender rule names a well-known name
+    CircuitBreaker breaker;          // Guarded by the breaker lock
+    gchar *breaker_error;            // Error name of calls failed by the open breaker
+    gint source_down;                // Source name unowned and calls are held (atomic, read by shards)
+    GQueue parked_calls;             // ParkedCall, oldest first (main loop)
+    gsize parked_bytes;
+    guint parked_timeout_id;         // Fails held calls once hold_timeout_ms passes
+    gint64 startup_started;          // Monotonic time startup began
+    gboolean introspected;           // Source objects discovered, ready to register
+    guint lanes_pending;             // Private source connections still opening
+    gboolean lanes_ready;            // Lanes and shards connected, ready to register
+    gint64 lanes_started;
+    guint name_owner_id;             // g_bus_own_name_on_connection ID
+    GMainLoop *main_loop;
+    int exit_status;                 // Non-zero once startup failed or the name was lost
+    GHashTable *interfaces;          // Interface name -> GDBusInterfaceInfo, shared by all objects
+    gsize *profile_method_calls;     // Calls per profile method id (atomic), NULL without a profile
+    GPtrArray *profile_method_names; // "interface.method" per profile method id
+    GHashTable *registered_objects;  // "path interface" -> registration ID
+    GHashTable *signal_subscriptions; // "path interface member" -> SignalSubscription
+    GArray *signal_match_ids;        // Source bus subscription IDs (one per match rule)
+    GHashTable *property_cache;      // "path interface" -> PropertyCacheEntry
+    guint message_filter_id;         // Target bus filter of the message-level engine
+    guint fd_signal_filter_id;       // Source bus filter relaying signals that carry fds
+    GPtrArray *source_lanes;         // SourceLane per pooled connection (or the shared bus)
+    SourceLane *bulk_lane;           // Separate connection for bulk methods, if configured
+    GHashTable *bulk_methods;        // Set of "interface.method" routed to bulk_lane
+    GPtrArray *shards;               // ProxyShard workers, NULL when everything runs on the main loop
+    GHashTable *pending_properties;  // "path interface" -> PendingPropertiesChanged
+    SignalQueue signal_queue;        // Outgoing signals emitted from the main loop
+    ProxyStats stats;
     ProxyConfig config;
 } ProxyState;
 
 static ProxyState *proxy_state = NULL;
 
+// Shard owning the calling thread, NULL on the main loop
+static thread_local ProxyShard *current_shard = NULL;
+
+// Guards proxy_state->admission, shared by the shards
+G_LOCK_DEFINE_STATIC(admission);
+
+// Guards proxy_state->breaker
+G_LOCK_DEFINE_STATIC(breaker);
+
 // Logging functions
 static void log_verbose(const char *format, ...)
 {
@@ -69,360 +447,4847 @@ static void log_info(const char *format, ...)
     va_end(args);
 }
 
-// Forward method calls from target bus to source bus
-static void handle_method_call(GDBusConnection *connection G_GNUC_UNUSED,
-                               const char *sender,
-                               const char *object_path,
-                               const char *interface_name,
-                               const char *method_name,
-                               GVariant *parameters,
-                               GDBusMethodInvocation *invocation,
-                               gpointer user_data G_GNUC_UNUSED)
+// Counters of the calling thread: its shard's, or the main loop's
+static ProxyStats *shard_stats()
 {
-    log_verbose("Method call: %s.%s from %s object_path=%s", interface_name, method_name, sender, object_path);
+    return current_shard ? &current_shard->stats : &proxy_state->stats;
+}
+
+static void proxy_stats_add(ProxyStats *total, const ProxyStats *stats)
+{
+    total->property_cache_hits += stats->property_cache_hits;
+    total->property_cache_misses += stats->property_cache_misses;
+    total->getall_forwarded += stats->getall_forwarded;
+    total->getall_calls_saved += stats->getall_calls_saved;
+    total->message_calls_forwarded += stats->message_calls_forwarded;
+    total->fds_forwarded += stats->fds_forwarded;
+    total->one_way_calls += stats->one_way_calls;
+    total->properties_changed_merged += stats->properties_changed_merged;
+    total->properties_changed_flushed += stats->properties_changed_flushed;
+    total->coalesce_max_delay_us = MAX(total->coalesce_max_delay_us, stats->coalesce_max_delay_us);
+    total->signals_emitted += stats->signals_emitted;
+    total->signals_dropped += stats->signals_dropped;
+    total->signals_coalesced += stats->signals_coalesced;
+    total->signal_queue_blocked += stats->signal_queue_blocked;
+    total->signal_queue_max_depth = MAX(total->signal_queue_max_depth, stats->signal_queue_max_depth);
+    total->signal_latency_total_us += stats->signal_latency_total_us;
+    total->signal_latency_max_us = MAX(total->signal_latency_max_us, stats->signal_latency_max_us);
+    total->object_cache_hits += stats->object_cache_hits;
+    total->object_cache_misses += stats->object_cache_misses;
+    total->object_cache_evictions += stats->object_cache_evictions;
+    total->managed_objects_served += stats->managed_objects_served;
+    total->interfaces_added += stats->interfaces_added;
+    total->interfaces_removed += stats->interfaces_removed;
+    total->profile_calls += stats->profile_calls;
+    total->source_restarts += stats->source_restarts;
+    total->resync_interfaces_changed += stats->resync_interfaces_changed;
+    total->admission_queued += stats->admission_queued;
+    total->admission_rejected += stats->admission_rejected;
+    total->admission_wait_total_us += stats->admission_wait_total_us;
+    total->calls_cancelled += stats->calls_cancelled;
+    total->calls_timed_out += stats->calls_timed_out;
+    total->calls_parked += stats->calls_parked;
+    total->parked_replayed += stats->parked_replayed;
+    total->parked_expired += stats->parked_expired;
+    total->parked_rejected += stats->parked_rejected;
+    total->parked_max_depth = MAX(total->parked_max_depth, stats->parked_max_depth);
+    total->park_time_total_us += stats->park_time_total_us;
+    total->park_time_max_us = MAX(total->park_time_max_us, stats->park_time_max_us);
+    total->breaker_rejected += stats->breaker_rejected;
+    for (guint c = 0; c < PRIORITY_CLASSES; c++) {
+        for (guint i = 0; i < LATENCY_BUCKETS; i++) {
+            total->call_latency[c][i] += stats->call_latency[c][i];
+            total->signal_latency[c][i] += stats->signal_latency[c][i];
+        }
+    }
+}
+
+static const char *const priority_class_names[PRIORITY_CLASSES] = { "interactive", "normal", "background" };
+
+// Histogram bucket of a latency: exact below 4 us, then four buckets per
+// power of two, so percentiles are within 25%
+static guint latency_bucket(guint64 us)
+{
+    if (us < 4) return (guint)us;
+    guint msb = g_bit_storage(us) - 1;
+    guint bucket = (msb - 1) * 4 + (guint)((us >> (msb - 2)) & 3);
+    return MIN(bucket, LATENCY_BUCKETS - 1);
+}
+
+// Upper bound in microseconds of the bucket holding the given fraction of
+// the samples
+static guint64 latency_percentile(const guint64 *histogram, gdouble fraction)
+{
+    guint64 count = 0;
+    for (guint i = 0; i < LATENCY_BUCKETS; i++) count += histogram[i];
+    
+    guint64 seen = 0;
+    for (guint i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += histogram[i];
+        if (seen > 0 && seen >= fraction * count) {
+            if (i < 4) return i;
+            guint shift = i / 4 - 1;
+            return ((guint64)(4 + i % 4 + 1) << shift) - 1;
+        }
+    }
+    return 0;
+}
+
+static const char *const breaker_state_names[] = { "closed", "open", "half-open" };
+
+static gboolean breaker_enabled()
+{
+    return proxy_state->config.breaker_error_rate > 0 || proxy_state->config.breaker_latency_ms > 0;
+}
+
+// Report runtime counters. Shard counters are read without locking, so
+// totals taken while the proxy is busy are approximate.
+static void log_stats()
+{
+    ProxyStats total = proxy_state->stats;
+    guint queue_depth = proxy_state->signal_queue.length;
+    for (guint i = 0; proxy_state->shards && i < proxy_state->shards->len; i++) {
+        ProxyShard *shard = (ProxyShard *)g_ptr_array_index(proxy_state->shards, i);
+        proxy_stats_add(&total, &shard->stats);
+        queue_depth += shard->signal_queue.length;
+        log_info("Stats: shard %u calls=%" G_GUINT64_FORMAT " in_flight=%u max_in_flight=%u",
+                 i, shard->lane->calls, shard->lane->in_flight, shard->lane->max_in_flight);
+    }
+    
+    if (proxy_state->signal_subscriptions) {
+        GHashTableIter iter;
+        gpointer value;
+        g_hash_table_iter_init(&iter, proxy_state->signal_subscriptions);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            SignalSubscription *sub = (SignalSubscription *)value;
+            if (sub->forwarded == 0) continue;
+            log_verbose("Stats: signal %s.%s on %s forwarded=%" G_GUINT64_FORMAT,
+                        sub->interface_name, sub->signal_name, sub->object_path, sub->forwarded);
+        }
+    }
+    
+    if (proxy_state->config.lazy_objects) {
+        log_info("Stats: object cache size=%u hits=%" G_GUINT64_FORMAT " misses=%" G_GUINT64_FORMAT
+                 " evictions=%" G_GUINT64_FORMAT,
+                 g_queue_get_length(&proxy_state->object_info_lru), total.object_cache_hits,
+                 total.object_cache_misses, total.object_cache_evictions);
+    }
+    
+    if (proxy_state->object_manager_path) {
+        log_info("Stats: object manager objects=%u served=%" G_GUINT64_FORMAT " interfaces_added=%" G_GUINT64_FORMAT
+                 " interfaces_removed=%" G_GUINT64_FORMAT,
+                 g_hash_table_size(proxy_state->objects), total.managed_objects_served,
+                 total.interfaces_added, total.interfaces_removed);
+    }
+    
+    if (proxy_state->config.hold_messages > 0) {
+        log_info("Stats: held calls depth=%u max_depth=%" G_GUINT64_FORMAT " parked=%" G_GUINT64_FORMAT
+                 " replayed=%" G_GUINT64_FORMAT " expired=%" G_GUINT64_FORMAT " rejected=%" G_GUINT64_FORMAT
+                 " hold_avg_us=%" G_GUINT64_FORMAT " hold_max_us=%" G_GUINT64_FORMAT,
+                 g_queue_get_length(&proxy_state->parked_calls), total.parked_max_depth, total.calls_parked,
+                 total.parked_replayed, total.parked_expired, total.parked_rejected,
+                 total.parked_replayed + total.parked_expired
+                     ? total.park_time_total_us / (total.parked_replayed + total.parked_expired) : 0,
+                 total.park_time_max_us);
+    }
+    
+    if (total.source_restarts > 0) {
+        log_info("Stats: source restarts=%" G_GUINT64_FORMAT " interfaces changed=%" G_GUINT64_FORMAT,
+                 total.source_restarts, total.resync_interfaces_changed);
+    }
+    
+    if (proxy_state->config.profile) {
+        const ProxyProfile *profile = proxy_state->config.profile;
+        log_info("Stats: profile %s calls=%" G_GUINT64_FORMAT, profile->name, total.profile_calls);
+        for (guint i = 0; i < proxy_state->profile_method_names->len; i++) {
+            gsize calls = (gsize)g_atomic_pointer_get(&proxy_state->profile_method_calls[i]);
+            if (calls == 0) continue;
+            log_verbose("Stats: profile method %s calls=%" G_GSIZE_FORMAT,
+                        (const char *)g_ptr_array_index(proxy_state->profile_method_names, i), calls);
+        }
+    }
+    
+    log_info("Stats: property cache hits=%" G_GUINT64_FORMAT " misses=%" G_GUINT64_FORMAT,
+             total.property_cache_hits,
+             total.property_cache_misses);
+    log_info("Stats: GetAll forwarded=%" G_GUINT64_FORMAT " upstream calls saved=%" G_GUINT64_FORMAT,
+             total.getall_forwarded,
+             total.getall_calls_saved);
+    if (proxy_state->config.message_forwarding) {
+        log_info("Stats: message-level calls forwarded=%" G_GUINT64_FORMAT,
+                 total.message_calls_forwarded);
+    }
+    if (proxy_state->config.max_in_flight > 0) {
+        G_LOCK(admission);
+        AdmissionControl *ac = &proxy_state->admission;
+        log_info("Stats: admission limit=%u in_flight=%u queued_now=%u queued=%" G_GUINT64_FORMAT
+                 " rejected=%" G_GUINT64_FORMAT " limit_decreases=%" G_GUINT64_FORMAT " wait_avg_us=%" G_GUINT64_FORMAT,
+                 (guint)ac->limit, ac->in_flight, ac->waiting, total.admission_queued,
+                 total.admission_rejected, ac->decreases,
+                 total.admission_queued ? total.admission_wait_total_us / total.admission_queued : 0);
+        GHashTableIter iter;
+        gpointer value;
+        g_hash_table_iter_init(&iter, ac->senders);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            SenderQueue *sq = (SenderQueue *)value;
+            log_verbose("Stats: caller %s weight=%u calls=%" G_GUINT64_FORMAT " bytes=%" G_GUINT64_FORMAT
+                        " queued=%" G_GUINT64_FORMAT " queued_now=%u wait_avg_us=%" G_GUINT64_FORMAT
+                        " wait_max_us=%" G_GUINT64_FORMAT, sq->sender, sq->weight, sq->calls, sq->bytes,
+                        sq->queued, sq->waiting, sq->queued ? sq->wait_total_us / sq->queued : 0,
+                        sq->wait_max_us);
+        }
+        G_UNLOCK(admission);
+    }
+    for (guint c = 0; c < PRIORITY_CLASSES; c++) {
+        const guint64 *calls = total.call_latency[c], *signals = total.signal_latency[c];
+        guint64 n_calls = 0, n_signals = 0;
+        for (guint i = 0; i < LATENCY_BUCKETS; i++) {
+            n_calls += calls[i];
+            n_signals += signals[i];
+        }
+        if (n_calls == 0 && n_signals == 0) continue;
+        log_info("Stats: priority %s calls=%" G_GUINT64_FORMAT " p50_us=%" G_GUINT64_FORMAT " p90_us=%" G_GUINT64_FORMAT
+                 " p99_us=%" G_GUINT64_FORMAT " signals=%" G_GUINT64_FORMAT " p50_us=%" G_GUINT64_FORMAT
+                 " p90_us=%" G_GUINT64_FORMAT " p99_us=%" G_GUINT64_FORMAT,
+                 priority_class_names[c], n_calls, latency_percentile(calls, 0.5), latency_percentile(calls, 0.9),
+                 latency_percentile(calls, 0.99), n_signals, latency_percentile(signals, 0.5),
+                 latency_percentile(signals, 0.9), latency_percentile(signals, 0.99));
+    }
+    if (breaker_enabled()) {
+        G_LOCK(breaker);
+        CircuitBreaker *b = &proxy_state->breaker;
+        gint64 open_us = b->open_total_us;
+        if (b->state != BREAKER_CLOSED) open_us += g_get_monotonic_time() - b->since;
+        log_info("Stats: circuit breaker state=%s trips=%" G_GUINT64_FORMAT " rejected=%" G_GUINT64_FORMAT
+                 " open_total_ms=%" G_GINT64_FORMAT " window_calls=%u window_failures=%u",
+                 breaker_state_names[b->state], b->trips, total.breaker_rejected, open_us / 1000,
+                 b->window_calls, b->window_failures);
+        G_UNLOCK(breaker);
+    }
+    log_info("Stats: forwarded calls cancelled=%" G_GUINT64_FORMAT " timed_out=%" G_GUINT64_FORMAT,
+             total.calls_cancelled, total.calls_timed_out);
+    log_info("Stats: unix fds forwarded=%" G_GUINT64_FORMAT, total.fds_forwarded);
+    log_info("Stats: one-way calls=%" G_GUINT64_FORMAT, total.one_way_calls);
+    if (proxy_state->pending_properties) {
+        log_info("Stats: PropertiesChanged merged=%" G_GUINT64_FORMAT " flushed=%" G_GUINT64_FORMAT
+                 " max_delay_us=%" G_GUINT64_FORMAT,
+                 total.properties_changed_merged, total.properties_changed_flushed,
+                 total.coalesce_max_delay_us);
+    }
+    if (proxy_state->config.signal_queue_messages > 0) {
+        log_info("Stats: signal queue depth=%u max_depth=%" G_GUINT64_FORMAT " emitted=%" G_GUINT64_FORMAT
+                 " dropped=%" G_GUINT64_FORMAT " coalesced=%" G_GUINT64_FORMAT " blocked=%" G_GUINT64_FORMAT
+                 " latency_avg_us=%" G_GUINT64_FORMAT " latency_max_us=%" G_GUINT64_FORMAT,
+                 queue_depth, total.signal_queue_max_depth, total.signals_emitted,
+                 total.signals_dropped, total.signals_coalesced, total.signal_queue_blocked,
+                 total.signals_emitted ? total.signal_latency_total_us / total.signals_emitted : 0,
+                 total.signal_latency_max_us);
+    }
+    for (guint i = 0; proxy_state->source_lanes && i < proxy_state->source_lanes->len; i++) {
+        SourceLane *lane = (SourceLane *)g_ptr_array_index(proxy_state->source_lanes, i);
+        log_info("Stats: source lane %u calls=%" G_GUINT64_FORMAT " in_flight=%u max_in_flight=%u",
+                 i, lane->calls, lane->in_flight, lane->max_in_flight);
+    }
+    if (proxy_state->bulk_lane) {
+        log_info("Stats: bulk lane calls=%" G_GUINT64_FORMAT " in_flight=%u max_in_flight=%u",
+                 proxy_state->bulk_lane->calls, proxy_state->bulk_lane->in_flight,
+                 proxy_state->bulk_lane->max_in_flight);
+    }
+}
+
+static void property_cache_entry_free(gpointer data)
+{
+    PropertyCacheEntry *entry = (PropertyCacheEntry *)data;
+    g_hash_table_destroy(entry->values);
+    g_free(entry);
+}
+
+// objects is read by connection filters on the GDBus worker thread; the
+// main loop takes this lock to change it
+G_LOCK_DEFINE_STATIC(mirrored_objects);
+
+// Whether a path is one of the mirrored objects. Safe from any thread.
+static gboolean object_is_mirrored(const char *object_path)
+{
+    if (!object_path) return FALSE;
+    
+    G_LOCK(mirrored_objects);
+    gboolean mirrored = g_hash_table_contains(proxy_state->objects, object_path);
+    G_UNLOCK(mirrored_objects);
+    return mirrored;
+}
+
+// Add, replace or remove (remove = TRUE) a mirrored object. The lazy mode
+// only keeps the names of its interfaces. Main loop only.
+static void mirrored_objects_set(const char *object_path, GDBusNodeInfo *node, gboolean remove)
+{
+    gpointer value = NULL;
+    
+    if (!remove && proxy_state->config.lazy_objects) {
+        guint n = 0;
+        while (node->interfaces && node->interfaces[n]) n++;
+        gchar **names = g_new0(gchar *, n + 1);
+        for (guint i = 0; i < n; i++) names[i] = g_strdup(node->interfaces[i]->name);
+        value = names;
+    } else if (!remove) {
+        value = g_dbus_node_info_ref(node);
+    }
+    
+    G_LOCK(mirrored_objects);
+    if (remove) {
+        g_hash_table_remove(proxy_state->objects, object_path);
+    } else {
+        g_hash_table_replace(proxy_state->objects, g_strdup(object_path), value);
+    }
+    G_UNLOCK(mirrored_objects);
+}
+
+static PropertyCacheEntry *property_cache_lookup_entry(const char *object_path, const char *interface_name)
+{
+    if (!proxy_state->property_cache) return NULL;
+    
+    gchar *key = g_strconcat(object_path, " ", interface_name, NULL);
+    PropertyCacheEntry *entry = (PropertyCacheEntry *)g_hash_table_lookup(proxy_state->property_cache, key);
+    g_free(key);
+    return entry;
+}
+
+// interfaces is read by the message engine on shard threads; the main
+// loop takes this lock to change it
+G_LOCK_DEFINE_STATIC(mirrored_interfaces);
+
+// Introspection data of an interface exposed by any discovered object.
+// Main loop only; other threads use lookup_interface_info_ref().
+static GDBusInterfaceInfo *lookup_interface_info(const char *interface_name)
+{
+    return interface_name ? (GDBusInterfaceInfo *)g_hash_table_lookup(proxy_state->interfaces, interface_name) : NULL;
+}
+
+// Like lookup_interface_info, with a reference the caller drops with
+// g_dbus_interface_info_unref(). Safe from any thread.
+static GDBusInterfaceInfo *lookup_interface_info_ref(const char *interface_name)
+{
+    if (!interface_name) return NULL;
+    
+    G_LOCK(mirrored_interfaces);
+    GDBusInterfaceInfo *iface = (GDBusInterfaceInfo *)g_hash_table_lookup(proxy_state->interfaces, interface_name);
+    if (iface) g_dbus_interface_info_ref(iface);
+    G_UNLOCK(mirrored_interfaces);
+    return iface;
+}
+
+// Add or replace (iface != NULL) or remove an interface by name. Main loop
+// only.
+static void mirrored_interfaces_set(const char *interface_name, GDBusInterfaceInfo *iface)
+{
+    G_LOCK(mirrored_interfaces);
+    if (iface) {
+        g_hash_table_replace(proxy_state->interfaces, iface->name, g_dbus_interface_info_ref(iface));
+    } else {
+        g_hash_table_remove(proxy_state->interfaces, interface_name);
+    }
+    G_UNLOCK(mirrored_interfaces);
+}
+
+// A property may only be cached if the source announces its changes. Properties
+// annotated EmitsChangedSignal=false (directly or via their interface) opt out.
+static gboolean property_is_cacheable(const char *interface_name, const char *property_name)
+{
+    GDBusInterfaceInfo *iface = lookup_interface_info(interface_name);
+    if (!iface) return FALSE;
+    
+    GDBusPropertyInfo *prop = g_dbus_interface_info_lookup_property(iface, property_name);
+    if (!prop) return FALSE;
+    
+    const char *emits = g_dbus_annotation_info_lookup(prop->annotations,
+                                                      "org.freedesktop.DBus.Property.EmitsChangedSignal");
+    if (!emits) {
+        emits = g_dbus_annotation_info_lookup(iface->annotations,
+                                              "org.freedesktop.DBus.Property.EmitsChangedSignal");
+    }
+    
+    return g_strcmp0(emits, "false") != 0;
+}
+
+// Number of readable properties of an introspected interface
+static guint count_readable_properties(const char *interface_name)
+{
+    GDBusInterfaceInfo *iface = lookup_interface_info(interface_name);
+    guint count = 0;
+    
+    for (int i = 0; iface && iface->properties && iface->properties[i]; i++) {
+        if (iface->properties[i]->flags & G_DBUS_PROPERTY_INFO_FLAGS_READABLE) count++;
+    }
+    return count;
+}
+
+// Create an (empty) cache entry for an interface registered on the target bus
+static void property_cache_add_interface(const char *object_path, GDBusInterfaceInfo *iface)
+{
+    if (!proxy_state->property_cache || !iface->properties || !iface->properties[0]) return;
+    
+    PropertyCacheEntry *entry = g_new0(PropertyCacheEntry, 1);
+    entry->values = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_variant_unref);
+    g_hash_table_replace(proxy_state->property_cache, g_strconcat(object_path, " ", iface->name, NULL), entry);
+}
+
+// Store a single property value unless it opted out of caching
+static void property_cache_store(PropertyCacheEntry *entry,
+                                 const char *interface_name,
+                                 const char *property_name,
+                                 GVariant *value)
+{
+    if (!property_is_cacheable(interface_name, property_name)) return;
+    
+    g_hash_table_replace(entry->values, g_strdup(property_name), g_variant_ref(value));
+}
+
+// Store every entry of an a{sv} dict (GetAll reply or PropertiesChanged payload)
+static void property_cache_store_all(PropertyCacheEntry *entry, const char *interface_name, GVariant *dict)
+{
+    GVariantIter iter;
+    const char *name;
+    GVariant *value;
+    
+    g_variant_iter_init(&iter, dict);
+    while (g_variant_iter_next(&iter, "{&sv}", &name, &value)) {
+        property_cache_store(entry, interface_name, name, value);
+        g_variant_unref(value);
+    }
+}
+
+// Apply a PropertiesChanged signal to the cache
+static void property_cache_apply_changes(const char *object_path, GVariant *parameters)
+{
+    const char *interface_name;
+    GVariant *changed;
+    GVariantIter *invalidated;
+    
+    g_variant_get(parameters, "(&s@a{sv}as)", &interface_name, &changed, &invalidated);
+    
+    PropertyCacheEntry *entry = property_cache_lookup_entry(object_path, interface_name);
+    if (entry) {
+        const char *name;
+        
+        entry->generation++;
+        property_cache_store_all(entry, interface_name, changed);
+        while (g_variant_iter_next(invalidated, "&s", &name)) {
+            g_hash_table_remove(entry->values, name);
+        }
+    }
+    
+    g_variant_unref(changed);
+    g_variant_iter_free(invalidated);
+}
+
+// Seed the cache of one interface with a single asynchronous GetAll
+static void property_cache_seed(const char *object_path, GDBusInterfaceInfo *iface)
+{
+    PropertyCacheEntry *entry = property_cache_lookup_entry(object_path, iface->name);
+    if (!entry) return;
+    
+    log_verbose("Seeding property cache: %s %s", object_path, iface->name);
+    
+    GVariant *key = g_variant_ref_sink(g_variant_new("(sst)", object_path, iface->name, entry->generation));
     
-    // Forward the call to the source bus
     g_dbus_connection_call(
         proxy_state->source_bus,
         proxy_state->config.source_bus_name,
-        proxy_state->config.source_object_path,
-        interface_name,
-        method_name,
-        parameters,
-        NULL, // Expected reply type (auto-detect)
+        object_path,
+        "org.freedesktop.DBus.Properties",
+        "GetAll",
+        g_variant_new("(s)", iface->name),
+        G_VARIANT_TYPE("(a{sv})"),
         G_DBUS_CALL_FLAGS_NONE,
-        -1, // Default timeout
-        NULL, // Cancellable
+        -1,
+        NULL,
         (GAsyncReadyCallback)[](GObject *source, GAsyncResult *res, gpointer user_data) {
-            GDBusMethodInvocation *inv = (GDBusMethodInvocation *)user_data;
+            GVariant *key = (GVariant *)user_data;
+            const char *path, *iface_name;
+            guint64 generation;
             GError *error = NULL;
             GVariant *result = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, &error);
             
+            g_variant_get(key, "(&s&st)", &path, &iface_name, &generation);
+            
             if (result) {
-                log_verbose("Method call successful, returning result");
-                g_dbus_method_invocation_return_value(inv, result);
+                PropertyCacheEntry *entry = property_cache_lookup_entry(path, iface_name);
+                // Skip the seed if a PropertiesChanged raced ahead of it
+                if (entry && entry->generation == generation) {
+                    GVariant *dict = g_variant_get_child_value(result, 0);
+                    property_cache_store_all(entry, iface_name, dict);
+                    g_variant_unref(dict);
+                }
+                g_variant_unref(result);
             } else {
-                log_error("Method call failed: %s", error ? error->message : "Unknown error");
-                g_dbus_method_invocation_return_gerror(inv, error);
-                if (error) g_error_free(error);
+                log_verbose("Property cache seed for %s failed: %s", iface_name, error->message);
+                g_error_free(error);
             }
+            g_variant_unref(key);
         },
-        invocation);
+        key);
 }
 
-// Handle property get requests
-static GVariant *handle_get_property(GDBusConnection *connection G_GNUC_UNUSED,
-                                     const char *sender,
-                                     const char *object_path G_GNUC_UNUSED,
-                                     const char *interface_name,
-                                     const char *property_name,
-                                     GError **error,
-                                     gpointer user_data G_GNUC_UNUSED)
+#define BREAKER_OPEN_MESSAGE "Source service is failing, call not forwarded"
+
+typedef enum {
+    BREAKER_SUCCESS,
+    BREAKER_FAILURE,
+    BREAKER_NO_SAMPLE   // Cancelled because the caller left; says nothing about the source
+} BreakerOutcome;
+
+// Errors that mean the source did not answer. Errors the service itself
+// returns, such as InvalidArgs, are answers and count as successes.
+static const char *const breaker_failure_errors[] = {
+    "org.freedesktop.DBus.Error.NoReply",
+    "org.freedesktop.DBus.Error.Timeout",
+    "org.freedesktop.DBus.Error.TimedOut",
+    "org.freedesktop.DBus.Error.ServiceUnknown",
+    "org.freedesktop.DBus.Error.NameHasNoOwner",
+    "org.freedesktop.DBus.Error.Disconnected",
+    "org.freedesktop.DBus.Error.NoMemory",
+    "org.freedesktop.DBus.Error.LimitsExceeded",
+    NULL
+};
+
+// Outcome of a forwarded call from its GError, or from the error name of
+// an error reply (message-level engine)
+static BreakerOutcome breaker_outcome(const GError *error, const char *error_name)
 {
-    log_verbose("Property get: %s.%s from %s", interface_name, property_name, sender);
+    if (!error && !error_name) return BREAKER_SUCCESS;
+    if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) return BREAKER_NO_SAMPLE;
+    // Local timeouts and closed connections; remote errors are G_IO_ERROR_DBUS_ERROR
+    if (error && error->domain == G_IO_ERROR && error->code != G_IO_ERROR_DBUS_ERROR) return BREAKER_FAILURE;
     
-    // Synchronously get property from source bus
-    GVariant *result = g_dbus_connection_call_sync(
-        proxy_state->source_bus,
-        proxy_state->config.source_bus_name,
-        proxy_state->config.source_object_path,
-        "org.freedesktop.DBus.Properties",
-        "Get",
-        g_variant_new("(ss)", interface_name, property_name),
-        G_VARIANT_TYPE("(v)"),
-        G_DBUS_CALL_FLAGS_NONE,
-        -1,
-        NULL,
-        error);
+    gchar *name = error ? g_dbus_error_encode_gerror(error) : g_strdup(error_name);
+    gboolean failed = g_strv_contains(breaker_failure_errors, name);
+    g_free(name);
+    return failed ? BREAKER_FAILURE : BREAKER_SUCCESS;
+}
+
+// Move the breaker to state. Called with the breaker lock held.
+static void breaker_set_state(CircuitBreaker *b, BreakerState state, gint64 now, const char *reason)
+{
+    log_info("Circuit breaker %s -> %s: %s", breaker_state_names[b->state], breaker_state_names[state], reason);
+    if (b->state != BREAKER_CLOSED) b->open_total_us += now - b->since;
+    if (state == BREAKER_OPEN) b->trips++;
+    b->state = state;
+    b->since = now;
+    b->window_start = now;
+    b->window_calls = 0;
+    b->window_failures = 0;
+    b->window_latency_us = 0;
+    b->probes = 0;
+    b->probes_passed = 0;
+}
+
+// Whether a call may be forwarded to the source. Runs on the caller's shard.
+static BreakerTicket breaker_enter()
+{
+    if (!breaker_enabled()) return BREAKER_PASS;
+    
+    CircuitBreaker *b = &proxy_state->breaker;
+    BreakerTicket ticket = BREAKER_PASS;
+    gint64 now = g_get_monotonic_time();
+    
+    G_LOCK(breaker);
+    if (b->state == BREAKER_OPEN && now - b->since >= (gint64)proxy_state->config.breaker_cooldown_ms * 1000) {
+        breaker_set_state(b, BREAKER_HALF_OPEN, now, "cooldown over, probing the source");
+    }
+    if (b->state == BREAKER_OPEN) {
+        ticket = BREAKER_REJECT;
+    } else if (b->state == BREAKER_HALF_OPEN) {
+        if (b->probes + b->probes_passed < proxy_state->config.breaker_probes) {
+            b->probes++;
+            ticket = BREAKER_PROBE;
+        } else {
+            ticket = BREAKER_REJECT;
+        }
+    }
+    G_UNLOCK(breaker);
+    
+    if (ticket == BREAKER_REJECT) shard_stats()->breaker_rejected++;
+    return ticket;
+}
+
+// Record the outcome of a call let through by breaker_enter(). Calls that
+// were never forwarded report BREAKER_NO_SAMPLE to release their probe.
+static void breaker_leave(BreakerTicket ticket, gint64 started, BreakerOutcome outcome)
+{
+    if (!breaker_enabled() || ticket == BREAKER_REJECT) return;
+    
+    CircuitBreaker *b = &proxy_state->breaker;
+    const ProxyConfig *config = &proxy_state->config;
+    gint64 now = g_get_monotonic_time();
+    gint64 latency = now - started;
+    gboolean slow = config->breaker_latency_ms > 0 && latency > (gint64)config->breaker_latency_ms * 1000;
+    
+    G_LOCK(breaker);
+    if (ticket == BREAKER_PROBE) {
+        // Probes of an earlier half-open period no longer count
+        if (b->state == BREAKER_HALF_OPEN && b->probes > 0) {
+            b->probes--;
+            if (outcome == BREAKER_FAILURE) {
+                breaker_set_state(b, BREAKER_OPEN, now, "probe failed");
+            } else if (outcome == BREAKER_SUCCESS && slow) {
+                breaker_set_state(b, BREAKER_OPEN, now, "probe too slow");
+            } else if (outcome == BREAKER_SUCCESS && ++b->probes_passed >= config->breaker_probes) {
+                breaker_set_state(b, BREAKER_CLOSED, now, "probes succeeded");
+            }
+        }
+    } else if (b->state == BREAKER_CLOSED && outcome != BREAKER_NO_SAMPLE) {
+        if (now - b->window_start > (gint64)config->breaker_window_ms * 1000) {
+            b->window_start = now;
+            b->window_calls = 0;
+            b->window_failures = 0;
+            b->window_latency_us = 0;
+        }
+        b->window_calls++;
+        if (outcome == BREAKER_FAILURE) b->window_failures++;
+        b->window_latency_us += latency;
+        
+        if (b->window_calls >= config->breaker_min_calls) {
+            gint64 mean_latency = b->window_latency_us / b->window_calls;
+            if (config->breaker_error_rate > 0 &&
+                (guint64)b->window_failures * 100 >= (guint64)config->breaker_error_rate * b->window_calls) {
+                gchar *reason = g_strdup_printf("%u of %u calls failed", b->window_failures, b->window_calls);
+                breaker_set_state(b, BREAKER_OPEN, now, reason);
+                g_free(reason);
+            } else if (config->breaker_latency_ms > 0 && mean_latency > (gint64)config->breaker_latency_ms * 1000) {
+                gchar *reason = g_strdup_printf("mean latency %.1f ms over %u calls",
+                                                mean_latency / 1000.0, b->window_calls);
+                breaker_set_state(b, BREAKER_OPEN, now, reason);
+                g_free(reason);
+            }
+        }
+    }
+    G_UNLOCK(breaker);
+}
+
+// Context of a Properties call forwarded to the source
+typedef struct {
+    GDBusMethodInvocation *invocation;
+    guint64 cache_generation;
+    GCancellable *cancellable;         // Cancelled when the caller leaves the target bus
+    BreakerTicket breaker;
+    gint64 started;
+} PropertyCallData;
+
+static GCancellable *caller_call_begin(const char *sender);
+static void caller_call_end(const char *sender, GCancellable *cancellable);
+static gint method_timeout_ms(const char *interface_name, const char *method_name);
+static void count_abandoned_call(const GError *error, const char *interface_name, const char *method_name);
+
+// Update the cache from the reply of a forwarded Properties call
+static void property_cache_update_from_reply(GDBusMethodInvocation *invocation,
+                                             guint64 generation,
+                                             GVariant *result)
+{
+    const char *method = g_dbus_method_invocation_get_method_name(invocation);
+    GVariant *parameters = g_dbus_method_invocation_get_parameters(invocation);
+    const char *iface_name;
+    g_variant_get_child(parameters, 0, "&s", &iface_name);
+    
+    PropertyCacheEntry *entry = property_cache_lookup_entry(g_dbus_method_invocation_get_object_path(invocation),
+                                                            iface_name);
+    if (!entry) return;
+    
+    if (g_strcmp0(method, "Set") == 0) {
+        // The source will announce the new value; drop ours until it does
+        const char *property_name;
+        g_variant_get_child(parameters, 1, "&s", &property_name);
+        entry->generation++;
+        g_hash_table_remove(entry->values, property_name);
+        return;
+    }
+    
+    if (entry->generation != generation) return;
+    
+    if (g_strcmp0(method, "Get") == 0) {
+        const char *property_name;
+        GVariant *value;
+        g_variant_get_child(parameters, 1, "&s", &property_name);
+        g_variant_get(result, "(v)", &value);
+        property_cache_store(entry, iface_name, property_name, value);
+        g_variant_unref(value);
+    } else if (g_strcmp0(method, "GetAll") == 0) {
+        GVariant *dict = g_variant_get_child_value(result, 0);
+        property_cache_store_all(entry, iface_name, dict);
+        g_variant_unref(dict);
+    }
+}
+
+// Count the fds of a list about to be passed on. The list keeps ownership
+// of its descriptors and closes them when the last reference goes away.
+static void count_forwarded_fds(GUnixFDList *fd_list)
+{
+    if (fd_list) shard_stats()->fds_forwarded += g_unix_fd_list_get_length(fd_list);
+}
+
+// Pick the source connection for a forwarded call. Calls from the same sender
+// always share a lane so each client keeps its ordering; methods listed with
+// --bulk-method go to their own lane so large transfers do not hold up the rest.
+static SourceLane *source_lane_for_call(const char *sender, const char *interface_name, const char *method_name)
+{
+    // Shards already partition callers by sender and each owns one connection
+    if (current_shard) return current_shard->lane;
+    
+    if (proxy_state->bulk_lane) {
+        gchar *key = g_strconcat(interface_name, ".", method_name, NULL);
+        gboolean bulk = g_hash_table_contains(proxy_state->bulk_methods, key);
+        g_free(key);
+        if (bulk) return proxy_state->bulk_lane;
+    }
+    
+    guint n_lanes = proxy_state->source_lanes->len;
+    guint index = (n_lanes > 1 && sender) ? g_str_hash(sender) % n_lanes : 0;
+    return (SourceLane *)g_ptr_array_index(proxy_state->source_lanes, index);
+}
+
+// Account for a call dispatched on a lane that expects a reply
+static GDBusConnection *source_lane_begin(SourceLane *lane)
+{
+    lane->calls++;
+    lane->in_flight++;
+    if (lane->in_flight > lane->max_in_flight) lane->max_in_flight = lane->in_flight;
+    return lane->connection;
+}
+
+// Account for the reply (or failure) of a call on the lane owning connection
+static void source_lane_end(GDBusConnection *connection)
+{
+    if (current_shard) {
+        current_shard->lane->in_flight--;
+        return;
+    }
+    
+    if (proxy_state->bulk_lane && proxy_state->bulk_lane->connection == connection) {
+        proxy_state->bulk_lane->in_flight--;
+        return;
+    }
+    
+    for (guint i = 0; i < proxy_state->source_lanes->len; i++) {
+        SourceLane *lane = (SourceLane *)g_ptr_array_index(proxy_state->source_lanes, i);
+        if (lane->connection == connection) {
+            lane->in_flight--;
+            return;
+        }
+    }
+}
+
+// Forward org.freedesktop.DBus.Properties Get/Set/GetAll calls to the source bus.
+// The vtable leaves get_property/set_property unset so GDBus routes these
+// through method_call, which lets us complete them asynchronously instead of
+// blocking the main loop on a synchronous round trip.
+static void handle_properties_call(const char *sender,
+                                   const char *object_path,
+                                   const char *method_name,
+                                   GVariant *parameters,
+                                   GDBusMethodInvocation *invocation)
+{
+    const GVariantType *reply_type;
+    
+    if (g_strcmp0(method_name, "Get") == 0) {
+        const char *iface_name, *property_name;
+        g_variant_get(parameters, "(&s&s)", &iface_name, &property_name);
+        log_verbose("Property get: %s.%s from %s", iface_name, property_name, sender);
+        
+        PropertyCacheEntry *entry = property_cache_lookup_entry(object_path, iface_name);
+        if (entry && property_is_cacheable(iface_name, property_name)) {
+            GVariant *value = (GVariant *)g_hash_table_lookup(entry->values, property_name);
+            if (value) {
+                proxy_state->stats.property_cache_hits++;
+                log_verbose("Property get served from cache");
+                g_dbus_method_invocation_return_value(invocation, g_variant_new("(v)", value));
+                return;
+            }
+            proxy_state->stats.property_cache_misses++;
+        }
+        reply_type = G_VARIANT_TYPE("(v)");
+    } else if (g_strcmp0(method_name, "Set") == 0) {
+        const char *iface_name, *property_name;
+        g_variant_get(parameters, "(&s&sv)", &iface_name, &property_name, NULL);
+        log_verbose("Property set: %s.%s from %s", iface_name, property_name, sender);
+        reply_type = G_VARIANT_TYPE("()");
+    } else if (g_strcmp0(method_name, "GetAll") == 0) {
+        // Forwarded as one upstream GetAll and relayed as-is, rather than
+        // letting GDBus fan it out into one Get per readable property
+        const char *iface_name;
+        g_variant_get(parameters, "(&s)", &iface_name);
+        log_verbose("Property get all: %s from %s", iface_name, sender);
+        
+        guint readable = count_readable_properties(iface_name);
+        proxy_state->stats.getall_forwarded++;
+        if (readable > 1) proxy_state->stats.getall_calls_saved += readable - 1;
+        reply_type = G_VARIANT_TYPE("(a{sv})");
+    } else {
+        g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD,
+                                              "Unknown method %s on org.freedesktop.DBus.Properties",
+                                              method_name);
+        return;
+    }
+    
+    BreakerTicket breaker = breaker_enter();
+    if (breaker == BREAKER_REJECT) {
+        g_dbus_method_invocation_return_dbus_error(invocation, proxy_state->breaker_error, BREAKER_OPEN_MESSAGE);
+        return;
+    }
+    
+    // Remember the cache generation so a reply that lost a race against a
+    // PropertiesChanged signal does not overwrite the newer value
+    const char *cache_iface;
+    g_variant_get_child(parameters, 0, "&s", &cache_iface);
+    PropertyCacheEntry *entry = property_cache_lookup_entry(object_path, cache_iface);
+    
+    PropertyCallData *data = g_new0(PropertyCallData, 1);
+    data->invocation = invocation;
+    data->cache_generation = entry ? entry->generation : 0;
+    data->cancellable = caller_call_begin(sender);
+    data->breaker = breaker;
+    data->started = g_get_monotonic_time();
+    
+    SourceLane *lane = source_lane_for_call(sender, "org.freedesktop.DBus.Properties", method_name);
+    
+    g_dbus_connection_call(
+        source_lane_begin(lane),
+        proxy_state->config.source_bus_name,
+        object_path,
+        "org.freedesktop.DBus.Properties",
+        method_name,
+        parameters,
+        reply_type,
+        G_DBUS_CALL_FLAGS_NONE,
+        method_timeout_ms("org.freedesktop.DBus.Properties", method_name),
+        data->cancellable,
+        (GAsyncReadyCallback)[](GObject *source, GAsyncResult *res, gpointer user_data) {
+            PropertyCallData *data = (PropertyCallData *)user_data;
+            GDBusMethodInvocation *inv = data->invocation;
+            const char *method = g_dbus_method_invocation_get_method_name(inv);
+            GError *error = NULL;
+            GVariant *result = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, &error);
+            
+            source_lane_end(G_DBUS_CONNECTION(source));
+            caller_call_end(g_dbus_method_invocation_get_sender(inv), data->cancellable);
+            breaker_leave(data->breaker, data->started, breaker_outcome(error, NULL));
+            
+            if (result) {
+                log_verbose("Property %s successful", method);
+                property_cache_update_from_reply(inv, data->cache_generation, result);
+                g_dbus_method_invocation_return_value(inv, result);
+                g_variant_unref(result);
+            } else {
+                count_abandoned_call(error, "org.freedesktop.DBus.Properties", method);
+                if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+                    log_error("Property %s failed: %s", method, error ? error->message : "Unknown error");
+                }
+                g_dbus_method_invocation_return_gerror(inv, error);
+                if (error) g_error_free(error);
+            }
+            g_free(data);
+        },
+        data);
+}
+
+// Forward a call whose sender set NO_REPLY_EXPECTED. The flag is passed on so
+// the source does not reply, and no pending-call state is kept.
+static void forward_one_way_call(GDBusMessage *call)
+{
+    GError *error = NULL;
+    GDBusMessage *upstream = g_dbus_message_new_method_call(proxy_state->config.source_bus_name,
+                                                            g_dbus_message_get_path(call),
+                                                            g_dbus_message_get_interface(call),
+                                                            g_dbus_message_get_member(call));
+    g_dbus_message_set_flags(upstream, g_dbus_message_get_flags(call));
+    g_dbus_message_set_body(upstream, g_dbus_message_get_body(call));
+    g_dbus_message_set_unix_fd_list(upstream, g_dbus_message_get_unix_fd_list(call));
+    count_forwarded_fds(g_dbus_message_get_unix_fd_list(call));
+    
+    SourceLane *lane = source_lane_for_call(g_dbus_message_get_sender(call),
+                                            g_dbus_message_get_interface(call),
+                                            g_dbus_message_get_member(call));
+    lane->calls++;
+    
+    if (!g_dbus_connection_send_message(lane->connection, upstream, G_DBUS_SEND_MESSAGE_FLAGS_NONE, NULL, &error)) {
+        log_error("One-way call failed: %s", error->message);
+        g_error_free(error);
+    }
+    
+    shard_stats()->one_way_calls++;
+    g_object_unref(upstream);
+}
+
+// Shard responsible for a key (sender or object path), NULL without shards
+static ProxyShard *shard_for_key(const char *key)
+{
+    if (!proxy_state->shards) return NULL;
+    
+    guint index = key ? g_str_hash(key) % proxy_state->shards->len : 0;
+    return (ProxyShard *)g_ptr_array_index(proxy_state->shards, index);
+}
+
+// Queue work on a shard's context, or on the main loop when shard is NULL.
+// Idle sources of equal priority run in the order they were attached, which
+// keeps the per-key ordering.
+static void shard_dispatch(ProxyShard *shard, GSourceFunc func, gpointer data)
+{
+    GSource *source = g_idle_source_new();
+    g_source_set_callback(source, func, data, NULL);
+    g_source_attach(source, shard ? shard->context : NULL);
+    g_source_unref(source);
+}
+
+// Calls are forwarded from the shards and callers leave on the main loop
+G_LOCK_DEFINE_STATIC(caller_calls);
+
+static void caller_calls_free(gpointer data)
+{
+    CallerCalls *calls = (CallerCalls *)data;
+    g_object_unref(calls->cancellable);
+    g_free(calls);
+}
+
+static void name_watch(const char *name);
+
+// Cancellable for a call about to be forwarded for sender. A sender that
+// left already is found out by the watch, which cancels it.
+static GCancellable *caller_call_begin(const char *sender)
+{
+    if (!sender) return NULL;
+    
+    name_watch(sender);
+    G_LOCK(caller_calls);
+    CallerCalls *calls = (CallerCalls *)g_hash_table_lookup(proxy_state->caller_calls, sender);
+    if (!calls) {
+        calls = g_new0(CallerCalls, 1);
+        calls->cancellable = g_cancellable_new();
+        g_hash_table_insert(proxy_state->caller_calls, g_strdup(sender), calls);
+    }
+    calls->in_flight++;
+    GCancellable *cancellable = (GCancellable *)g_object_ref(calls->cancellable);
+    G_UNLOCK(caller_calls);
+    return cancellable;
+}
+
+// A forwarded call got its reply (or was cancelled)
+static void caller_call_end(const char *sender, GCancellable *cancellable)
+{
+    if (!cancellable) return;
+    
+    G_LOCK(caller_calls);
+    CallerCalls *calls = (CallerCalls *)g_hash_table_lookup(proxy_state->caller_calls, sender);
+    // Entries of callers that left are gone already
+    if (calls && calls->cancellable == cancellable && --calls->in_flight == 0) {
+        g_hash_table_remove(proxy_state->caller_calls, sender);
+    }
+    G_UNLOCK(caller_calls);
+    g_object_unref(cancellable);
+}
+
+static void admission_forget_sender(const char *sender);
+static void sender_name_owner_changed(const char *name, const char *new_owner);
+static void sender_name_resolve(const char *name);
+
+// A target caller left. Unique names are never reused, so it will not read
+// the replies of its forwarded calls; they are cancelled, which frees their
+// pending state right away. The source is not told: D-Bus has no way to
+// abort a call already delivered. Runs on the main loop.
+static void caller_left(const char *name)
+{
+    admission_forget_sender(name);
+    
+    GCancellable *cancellable = NULL;
+    gpointer watch_id = NULL;
+    G_LOCK(caller_calls);
+    CallerCalls *calls = (CallerCalls *)g_hash_table_lookup(proxy_state->caller_calls, name);
+    if (calls) {
+        log_verbose("Caller %s left, cancelling %u forwarded call(s)", name, calls->in_flight);
+        cancellable = (GCancellable *)g_object_ref(calls->cancellable);
+        g_hash_table_remove(proxy_state->caller_calls, name);
+    }
+    if (g_hash_table_lookup_extended(proxy_state->name_watches, name, NULL, &watch_id)) {
+        g_hash_table_remove(proxy_state->name_watches, name);
+    }
+    G_UNLOCK(caller_calls);
+    
+    if (watch_id) g_dbus_connection_signal_unsubscribe(proxy_state->target_bus, GPOINTER_TO_UINT(watch_id));
+    if (cancellable) {
+        g_cancellable_cancel(cancellable);
+        g_object_unref(cancellable);
+    }
+}
+
+// NameOwnerChanged of a watched name on the target bus. Owner changes of
+// well-known names move their --sender-weight and --priority rule.
+static void on_target_name_owner_changed(GDBusConnection *connection G_GNUC_UNUSED,
+                                         const char *sender_name G_GNUC_UNUSED,
+                                         const char *object_path G_GNUC_UNUSED,
+                                         const char *interface_name G_GNUC_UNUSED,
+                                         const char *signal_name G_GNUC_UNUSED,
+                                         GVariant *parameters,
+                                         gpointer user_data G_GNUC_UNUSED)
+{
+    const char *name, *old_owner, *new_owner;
+    g_variant_get(parameters, "(&s&s&s)", &name, &old_owner, &new_owner);
+    if (name[0] != ':') {
+        sender_name_owner_changed(name, new_owner);
+        return;
+    }
+    if (new_owner[0] == '\0') caller_left(name);
+}
+
+// Subscribe to a watched name's NameOwnerChanged, then check the name: a
+// caller may have left before the match rule was in place. Runs on the
+// main loop.
+static gboolean name_watch_start(gpointer user_data)
+{
+    gchar *name = (gchar *)user_data;
+    guint watch_id = g_dbus_connection_signal_subscribe(proxy_state->target_bus,
+                                                        "org.freedesktop.DBus",
+                                                        "org.freedesktop.DBus",
+                                                        "NameOwnerChanged",
+                                                        "/org/freedesktop/DBus",
+                                                        name, // arg0
+                                                        G_DBUS_SIGNAL_FLAGS_NONE,
+                                                        on_target_name_owner_changed,
+                                                        NULL, // user_data
+                                                        NULL); // user_data_free_func
+    
+    // Only the main loop removes watches
+    G_LOCK(caller_calls);
+    g_hash_table_replace(proxy_state->name_watches, g_strdup(name), GUINT_TO_POINTER(watch_id));
+    G_UNLOCK(caller_calls);
+    
+    if (name[0] != ':') {
+        sender_name_resolve(name);
+        g_free(name);
+        return G_SOURCE_REMOVE;
+    }
+    
+    g_dbus_connection_call(proxy_state->target_bus,
+                           "org.freedesktop.DBus",
+                           "/org/freedesktop/DBus",
+                           "org.freedesktop.DBus",
+                           "NameHasOwner",
+                           g_variant_new("(s)", name),
+                           G_VARIANT_TYPE("(b)"),
+                           G_DBUS_CALL_FLAGS_NONE,
+                           -1,
+                           NULL,
+                           [](GObject *source, GAsyncResult *res, gpointer user_data) {
+                               gchar *name = (gchar *)user_data;
+                               GVariant *result = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, NULL);
+                               if (result) {
+                                   gboolean has_owner;
+                                   g_variant_get(result, "(b)", &has_owner);
+                                   if (!has_owner) caller_left(name);
+                                   g_variant_unref(result);
+                               }
+                               g_free(name);
+                           },
+                           name);
+    return G_SOURCE_REMOVE;
+}
+
+// Watch a target bus name for owner changes: callers, to notice them
+// leaving, and the well-known names of sender rules. One arg0 match per
+// name keeps the rest of the bus's name changes away. Runs on any thread.
+static void name_watch(const char *name)
+{
+    G_LOCK(caller_calls);
+    gboolean watched = g_hash_table_contains(proxy_state->name_watches, name);
+    if (!watched) g_hash_table_insert(proxy_state->name_watches, g_strdup(name), NULL);
+    G_UNLOCK(caller_calls);
+    
+    if (!watched) shard_dispatch(NULL, name_watch_start, g_strdup(name));
+}
+
+// Timeout of a forwarded call: --method-timeout for the method or its
+// interface, else --call-timeout
+static gint method_timeout_ms(const char *interface_name, const char *method_name)
+{
+    GHashTable *timeouts = proxy_state->config.method_timeouts;
+    
+    if (g_hash_table_size(timeouts) > 0) {
+        gchar *key = g_strconcat(interface_name, ".", method_name, NULL);
+        gpointer timeout;
+        gboolean found = g_hash_table_lookup_extended(timeouts, key, NULL, &timeout) ||
+                         g_hash_table_lookup_extended(timeouts, interface_name, NULL, &timeout);
+        g_free(key);
+        if (found) return GPOINTER_TO_INT(timeout);
+    }
+    return proxy_state->config.call_timeout_ms;
+}
+
+// Count calls that ended without a reply from the source
+static void count_abandoned_call(const GError *error, const char *interface_name, const char *method_name)
+{
+    if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        log_verbose("Forwarded call %s.%s cancelled, caller left", interface_name, method_name);
+        shard_stats()->calls_cancelled++;
+    } else if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT)) {
+        shard_stats()->calls_timed_out++;
+    }
+}
+
+// Priority class of a call or signal (sender NULL): the class of the first
+// --priority rule it matches
+static PriorityClass message_priority(const char *sender, const char *interface_name, const char *member)
+{
+    GPtrArray *rules = proxy_state->config.priority_rules;
+    if (rules->len == 0) return PRIORITY_NORMAL;
+    
+    // Sender rules naming well-known names match through their current owner
+    guint owned_rule = 0;
+    if (sender && proxy_state->priority_sender_names) {
+        G_LOCK(admission);
+        owned_rule = GPOINTER_TO_UINT(g_hash_table_lookup(proxy_state->admission.priority_owners, sender));
+        G_UNLOCK(admission);
+    }
+    
+    for (guint i = 0; i < rules->len; i++) {
+        const PriorityRule *rule = (const PriorityRule *)g_ptr_array_index(rules, i);
+        gboolean matched;
+        switch (rule->match) {
+        case PRIORITY_MATCH_INTERFACE:
+            matched = g_strcmp0(rule->name, interface_name) == 0;
+            break;
+        case PRIORITY_MATCH_MEMBER:
+            matched = g_strcmp0(rule->name, member) == 0;
+            break;
+        default:
+            matched = sender && (g_strcmp0(rule->name, sender) == 0 || owned_rule == i + 1);
+            break;
+        }
+        if (matched) return rule->priority;
+    }
+    return PRIORITY_NORMAL;
+}
+
+// Class to serve next out of those with work (ready): the highest one,
+// except that a class passed over priority_starvation times in a row goes
+// first. Returns PRIORITY_CLASSES when none is ready.
+static guint priority_pick(const gboolean *ready, guint *passed_over)
+{
+    guint starvation = proxy_state->config.priority_starvation;
+    guint pick = PRIORITY_CLASSES;
+    
+    for (guint c = 0; c < PRIORITY_CLASSES; c++) {
+        if (!ready[c]) {
+            passed_over[c] = 0;
+        } else if (pick == PRIORITY_CLASSES) {
+            pick = c;
+        } else if (starvation > 0 && passed_over[c] >= starvation && passed_over[pick] < starvation) {
+            pick = c;
+        }
+    }
+    for (guint c = pick + 1; c < PRIORITY_CLASSES; c++) {
+        if (ready[c]) passed_over[c]++;
+    }
+    if (pick < PRIORITY_CLASSES) passed_over[pick] = 0;
+    return pick;
+}
+
+static void count_call_latency(PriorityClass priority, gint64 arrived)
+{
+    shard_stats()->call_latency[priority][latency_bucket(g_get_monotonic_time() - arrived)]++;
+}
+
+// Calls forwarded to a profile method. Runs on any shard.
+static void count_profile_call(const ProxyProfileMethodInfo *profile_method)
+{
+    shard_stats()->profile_calls++;
+    g_atomic_pointer_add(&proxy_state->profile_method_calls[profile_method->id], 1);
+}
+
+typedef enum {
+    ADMISSION_ADMITTED,   // Forward now
+    ADMISSION_QUEUED,     // Resumed by admission_leave() once a slot frees
+    ADMISSION_REJECTED    // Queue full, fail with LimitsExceeded
+} AdmissionResult;
+
+static void forward_method_call_admitted(ForwardedCall *call);
+static void forward_method_message_admitted(ForwardedCall *forwarded);
+
+#define ADMISSION_REJECTED_ERROR "org.freedesktop.DBus.Error.LimitsExceeded"
+#define ADMISSION_REJECTED_MESSAGE "Source service is at its concurrency limit, retry later"
+
+// Cost of a call for deficit round robin: its body plus a fixed share
+// for the header and dispatch, so empty calls are not free
+#define ADMISSION_CALL_COST 128
+// Bytes a sender of weight 1 may send per round
+#define ADMISSION_QUANTUM 1024
+
+static void sender_queue_free(gpointer data)
+{
+    SenderQueue *sq = (SenderQueue *)data;
+    g_free(sq->sender);
+    g_free(sq);
+}
+
+// Queue and counters of a sender, created on its first call. Called with
+// the admission lock held.
+static SenderQueue *sender_queue_get(AdmissionControl *ac, const char *sender)
+{
+    SenderQueue *sq = (SenderQueue *)g_hash_table_lookup(ac->senders, sender);
+    if (sq) return sq;
+    
+    sq = g_new0(SenderQueue, 1);
+    sq->sender = g_strdup(sender);
+    for (guint c = 0; c < PRIORITY_CLASSES; c++) {
+        sq->lanes[c].owner = sq;
+        g_queue_init(&sq->lanes[c].waiting);
+    }
+    sq->weight = GPOINTER_TO_UINT(g_hash_table_lookup(ac->weights, sender));
+    if (sq->weight == 0) sq->weight = GPOINTER_TO_UINT(g_hash_table_lookup(proxy_state->config.sender_weights, sender));
+    if (sq->weight == 0) sq->weight = 1;
+    g_hash_table_insert(ac->senders, sq->sender, sq);
+    return sq;
+}
+
+// Next waiting call: the class is picked by priority_pick(), then within
+// it by deficit round robin: the sender at the head of the round is served
+// while its deficit covers its oldest call, otherwise it gets weight quanta
+// more and goes to the back. Called with the lock held.
+static AdmissionWaiter *admission_next(AdmissionControl *ac)
+{
+    gboolean ready[PRIORITY_CLASSES];
+    for (guint c = 0; c < PRIORITY_CLASSES; c++) ready[c] = !g_queue_is_empty(&ac->active[c]);
+    guint priority = priority_pick(ready, ac->passed_over);
+    if (priority == PRIORITY_CLASSES) return NULL;
+    
+    GQueue *active = &ac->active[priority];
+    for (;;) {
+        SenderLane *lane = (SenderLane *)g_queue_peek_head(active);
+        AdmissionWaiter *waiter = (AdmissionWaiter *)g_queue_peek_head(&lane->waiting);
+        
+        if (lane->deficit < (gint64)waiter->cost) {
+            lane->deficit += (gint64)ADMISSION_QUANTUM * lane->owner->weight;
+            g_queue_push_tail(active, g_queue_pop_head(active));
+            continue;
+        }
+        
+        g_queue_pop_head(&lane->waiting);
+        lane->deficit -= waiter->cost;
+        lane->owner->waiting--;
+        ac->waiting--;
+        if (g_queue_is_empty(&lane->waiting)) {
+            // Idle senders do not bank credit
+            lane->deficit = 0;
+            lane->active = FALSE;
+            g_queue_pop_head(active);
+        }
+        
+        guint64 waited = (guint64)(g_get_monotonic_time() - waiter->queued);
+        lane->owner->wait_total_us += waited;
+        lane->owner->wait_max_us = MAX(lane->owner->wait_max_us, waited);
+        return waiter;
+    }
+}
+
+// Fail a call that will not be forwarded, and release it
+static void admission_fail(ForwardedCall *call, const char *error_name, const char *reason)
+{
+    if (call->invocation) {
+        g_dbus_method_invocation_return_dbus_error(call->invocation, error_name, reason);
+    } else {
+        GDBusMessage *error_reply = g_dbus_message_new_method_error_literal(call->message, error_name, reason);
+        g_dbus_connection_send_message(proxy_state->target_bus, error_reply, G_DBUS_SEND_MESSAGE_FLAGS_NONE, NULL, NULL);
+        g_object_unref(error_reply);
+        g_object_unref(call->message);
+    }
+    g_free(call);
+}
+
+// Take an in-flight slot for a call, or queue it. Runs on the caller's shard.
+static AdmissionResult admission_enter(ForwardedCall *call)
+{
+    if (proxy_state->config.max_in_flight == 0) return ADMISSION_ADMITTED;
+    
+    AdmissionControl *ac = &proxy_state->admission;
+    AdmissionResult result = ADMISSION_ADMITTED;
+    AdmissionWaiter *evicted = NULL;
+    const char *sender = call->invocation ? g_dbus_method_invocation_get_sender(call->invocation)
+                                          : g_dbus_message_get_sender(call->message);
+    GVariant *body = call->invocation ? g_dbus_method_invocation_get_parameters(call->invocation)
+                                      : g_dbus_message_get_body(call->message);
+    gsize bytes = body ? g_variant_get_size(body) : 0;
+    
+    G_LOCK(admission);
+    SenderQueue *sq = sender_queue_get(ac, sender ? sender : "");
+    sq->calls++;
+    sq->bytes += bytes;
+    
+    if (ac->in_flight < (guint)ac->limit && ac->waiting == 0) {
+        ac->in_flight++;
+    } else {
+        // A full queue makes room at the expense of the longest sender queue,
+        // so one client cannot fill it and lock the others out. That sender
+        // gives up its newest call of its lowest class.
+        if (ac->waiting >= proxy_state->config.admission_queue) {
+            SenderQueue *longest = NULL;
+            for (guint c = 0; c < PRIORITY_CLASSES; c++) {
+                for (GList *l = ac->active[c].head; l; l = l->next) {
+                    SenderQueue *candidate = ((SenderLane *)l->data)->owner;
+                    if (!longest || candidate->waiting > longest->waiting) longest = candidate;
+                }
+            }
+            if (longest && longest != sq && longest->waiting > sq->waiting + 1) {
+                for (guint c = PRIORITY_CLASSES; c-- > 0 && !evicted;) {
+                    evicted = (AdmissionWaiter *)g_queue_pop_tail(&longest->lanes[c].waiting);
+                }
+                SenderLane *lane = &longest->lanes[evicted->call->priority];
+                if (g_queue_is_empty(&lane->waiting)) {
+                    lane->deficit = 0;
+                    lane->active = FALSE;
+                    g_queue_remove(&ac->active[evicted->call->priority], lane);
+                }
+                longest->waiting--;
+                ac->waiting--;
+            } else {
+                result = ADMISSION_REJECTED;
+            }
+        }
+        
+        if (result != ADMISSION_REJECTED) {
+            AdmissionWaiter *waiter = g_new0(AdmissionWaiter, 1);
+            waiter->shard = current_shard;
+            waiter->call = call;
+            waiter->cost = bytes + ADMISSION_CALL_COST;
+            waiter->queued = g_get_monotonic_time();
+            SenderLane *lane = &sq->lanes[call->priority];
+            g_queue_push_tail(&lane->waiting, waiter);
+            sq->waiting++;
+            ac->waiting++;
+            sq->queued++;
+            if (!lane->active) {
+                lane->active = TRUE;
+                g_queue_push_tail(&ac->active[call->priority], lane);
+            }
+            result = ADMISSION_QUEUED;
+        }
+    }
+    G_UNLOCK(admission);
+    
+    if (result == ADMISSION_QUEUED) shard_stats()->admission_queued++;
+    if (result == ADMISSION_REJECTED || evicted) shard_stats()->admission_rejected++;
+    if (evicted) {
+        breaker_leave(evicted->call->breaker, 0, BREAKER_NO_SAMPLE);
+        admission_fail(evicted->call, ADMISSION_REJECTED_ERROR, ADMISSION_REJECTED_MESSAGE);
+        g_free(evicted);
+    }
+    return result;
+}
+
+// Resume a queued call on its shard; it already holds its slot
+static void admission_resume(AdmissionWaiter *waiter)
+{
+    shard_dispatch(waiter->shard,
+                   [](gpointer data) -> gboolean {
+                       AdmissionWaiter *waiter = (AdmissionWaiter *)data;
+                       shard_stats()->admission_wait_total_us += g_get_monotonic_time() - waiter->queued;
+                       if (waiter->call->invocation) {
+                           forward_method_call_admitted(waiter->call);
+                       } else {
+                           forward_method_message_admitted(waiter->call);
+                       }
+                       g_free(waiter);
+                       return G_SOURCE_REMOVE;
+                   },
+                   waiter);
+}
+
+// Release the slot of a forwarded call that finished, adjust the limit from
+// its latency and hand freed slots to waiting calls. Cancelled calls say
+// nothing about the source and leave the limit alone.
+static void admission_leave(gint64 started, const GError *error)
+{
+    if (proxy_state->config.max_in_flight == 0) return;
+    
+    AdmissionControl *ac = &proxy_state->admission;
+    gint64 now = g_get_monotonic_time();
+    gint64 latency = now - started;
+    gint64 target = (gint64)proxy_state->config.latency_target_ms * 1000;
+    GQueue resume = G_QUEUE_INIT;
+    AdmissionWaiter *waiter;
+    
+    G_LOCK(admission);
+    ac->in_flight--;
+    if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        // No sample
+    } else if (latency > target || g_error_matches(error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT)) {
+        // Replies already in flight when the limit was cut are just as slow;
+        // cut once per target interval rather than once per reply
+        if (now - ac->last_decrease >= target) {
+            ac->limit = MAX(1.0, ac->limit * 0.75);
+            ac->last_decrease = now;
+            ac->decreases++;
+        }
+    } else {
+        ac->limit = MIN((gdouble)proxy_state->config.max_in_flight, ac->limit + 1.0 / ac->limit);
+    }
+    while (ac->in_flight < (guint)ac->limit && (waiter = admission_next(ac))) {
+        ac->in_flight++;
+        g_queue_push_tail(&resume, waiter);
+    }
+    G_UNLOCK(admission);
+    
+    while ((waiter = (AdmissionWaiter *)g_queue_pop_head(&resume))) {
+        admission_resume(waiter);
+    }
+}
+
+// A target client left: drop its queue and counters and fail its waiting
+// calls, which nobody will read. Runs on the main loop.
+static void admission_forget_sender(const char *sender)
+{
+    AdmissionControl *ac = &proxy_state->admission;
+    GQueue dropped = G_QUEUE_INIT;
+    
+    G_LOCK(admission);
+    g_hash_table_remove(ac->weights, sender);
+    g_hash_table_remove(ac->priority_owners, sender);
+    SenderQueue *sq = (SenderQueue *)g_hash_table_lookup(ac->senders, sender);
+    if (sq) {
+        log_verbose("Caller %s left: calls=%" G_GUINT64_FORMAT " bytes=%" G_GUINT64_FORMAT " queued=%" G_GUINT64_FORMAT
+                    " wait_max_us=%" G_GUINT64_FORMAT, sender, sq->calls, sq->bytes, sq->queued, sq->wait_max_us);
+        for (guint c = 0; c < PRIORITY_CLASSES; c++) {
+            SenderLane *lane = &sq->lanes[c];
+            if (lane->active) g_queue_remove(&ac->active[c], lane);
+            while (!g_queue_is_empty(&lane->waiting)) g_queue_push_tail(&dropped, g_queue_pop_head(&lane->waiting));
+        }
+        ac->waiting -= sq->waiting;
+        g_hash_table_remove(ac->senders, sender);
+    }
+    G_UNLOCK(admission);
+    
+    AdmissionWaiter *waiter;
+    while ((waiter = (AdmissionWaiter *)g_queue_pop_head(&dropped))) {
+        shard_stats()->calls_cancelled++;
+        breaker_leave(waiter->call->breaker, 0, BREAKER_NO_SAMPLE);
+        admission_fail(waiter->call, "org.freedesktop.DBus.Error.NoReply", "Caller left");
+        g_free(waiter);
+    }
+}
+
+// Weight and priority rule of a well-known name from --sender-weight and
+// --priority now apply to the unique name owning it. Runs on the main loop.
+static void sender_name_owner_changed(const char *name, const char *new_owner)
+{
+    if (!new_owner || !new_owner[0]) return;
+    
+    guint weight = GPOINTER_TO_UINT(g_hash_table_lookup(proxy_state->config.sender_weights, name));
+    guint rule = 0;
+    GPtrArray *rules = proxy_state->config.priority_rules;
+    for (guint i = 0; i < rules->len && rule == 0; i++) {
+        const PriorityRule *r = (const PriorityRule *)g_ptr_array_index(rules, i);
+        if (r->match == PRIORITY_MATCH_SENDER && g_strcmp0(r->name, name) == 0) rule = i + 1;
+    }
+    if (weight == 0 && rule == 0) return;
+    
+    AdmissionControl *ac = &proxy_state->admission;
+    G_LOCK(admission);
+    if (weight > 0) {
+        g_hash_table_replace(ac->weights, g_strdup(new_owner), GUINT_TO_POINTER(weight));
+        SenderQueue *sq = (SenderQueue *)g_hash_table_lookup(ac->senders, new_owner);
+        if (sq) sq->weight = weight;
+    }
+    if (rule > 0) {
+        // The first rule wins when the owner holds several matched names
+        guint current = GPOINTER_TO_UINT(g_hash_table_lookup(ac->priority_owners, new_owner));
+        if (current == 0 || rule < current) {
+            g_hash_table_replace(ac->priority_owners, g_strdup(new_owner), GUINT_TO_POINTER(rule));
+        }
+    }
+    G_UNLOCK(admission);
+    // The owner's entries go once it leaves the bus
+    name_watch(new_owner);
+    if (weight > 0) log_verbose("Fair queueing weight %u for %s (%s)", weight, name, new_owner);
+    if (rule > 0) log_verbose("Priority rule %u for %s (%s)", rule, name, new_owner);
+}
+
+// Apply the current owner of a well-known name, if it has one
+static void sender_name_resolve(const char *name)
+{
+    g_dbus_connection_call(proxy_state->target_bus,
+                           "org.freedesktop.DBus",
+                           "/org/freedesktop/DBus",
+                           "org.freedesktop.DBus",
+                           "GetNameOwner",
+                           g_variant_new("(s)", name),
+                           G_VARIANT_TYPE("(s)"),
+                           G_DBUS_CALL_FLAGS_NONE,
+                           -1,
+                           NULL,
+                           [](GObject *source, GAsyncResult *res, gpointer user_data) {
+                               gchar *name = (gchar *)user_data;
+                               // Not owned yet: NameOwnerChanged will tell
+                               GVariant *result = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, NULL);
+                               if (result) {
+                                   const char *owner;
+                                   g_variant_get(result, "(&s)", &owner);
+                                   sender_name_owner_changed(name, owner);
+                                   g_variant_unref(result);
+                               }
+                               g_free(name);
+                           },
+                           g_strdup(name));
+}
+
+// Watch the well-known names given weights or priority rules; their
+// current owners are looked up once the watch is in place
+static void sender_names_resolve(void)
+{
+    GHashTableIter iter;
+    gpointer key;
+    if (proxy_state->config.max_in_flight > 0) {
+        g_hash_table_iter_init(&iter, proxy_state->config.sender_weights);
+        while (g_hash_table_iter_next(&iter, &key, NULL)) {
+            if (((const char *)key)[0] != ':') name_watch((const char *)key);
+        }
+    }
+    
+    GPtrArray *rules = proxy_state->config.priority_rules;
+    for (guint i = 0; i < rules->len; i++) {
+        const PriorityRule *rule = (const PriorityRule *)g_ptr_array_index(rules, i);
+        if (rule->match == PRIORITY_MATCH_SENDER && rule->name[0] != ':') name_watch(rule->name);
+    }
+}
+
+// Forward a method call to the source bus. Runs on the caller's shard.
+static void forward_method_call(ForwardedCall *call)
+{
+    GDBusMethodInvocation *invocation = call->invocation;
+    const char *sender = g_dbus_method_invocation_get_sender(invocation);
+    const char *object_path = g_dbus_method_invocation_get_object_path(invocation);
+    const char *interface_name = g_dbus_method_invocation_get_interface_name(invocation);
+    const char *method_name = g_dbus_method_invocation_get_method_name(invocation);
+    
+    log_verbose("Method call: %s.%s from %s object_path=%s", interface_name, method_name, sender, object_path);
+    
+    GDBusMessage *message = g_dbus_method_invocation_get_message(invocation);
+    if (g_dbus_message_get_flags(message) & G_DBUS_MESSAGE_FLAGS_NO_REPLY_EXPECTED) {
+        forward_one_way_call(message);
+        // Releases the invocation; GDBus sends nothing for NO_REPLY_EXPECTED calls
+        g_dbus_method_invocation_return_value(invocation, NULL);
+        g_free(call);
+        return;
+    }
+    
+    call->breaker = breaker_enter();
+    if (call->breaker == BREAKER_REJECT) {
+        admission_fail(call, proxy_state->breaker_error, BREAKER_OPEN_MESSAGE);
+        return;
+    }
+    
+    call->priority = message_priority(sender, interface_name, method_name);
+    switch (admission_enter(call)) {
+    case ADMISSION_ADMITTED:
+        forward_method_call_admitted(call);
+        break;
+    case ADMISSION_QUEUED:
+        break;
+    case ADMISSION_REJECTED:
+        breaker_leave(call->breaker, 0, BREAKER_NO_SAMPLE);
+        admission_fail(call, ADMISSION_REJECTED_ERROR, ADMISSION_REJECTED_MESSAGE);
+        break;
+    }
+}
+
+// Second half of forward_method_call, once the call holds an in-flight slot
+static void forward_method_call_admitted(ForwardedCall *call)
+{
+    GDBusMethodInvocation *invocation = call->invocation;
+    const char *sender = g_dbus_method_invocation_get_sender(invocation);
+    const char *object_path = g_dbus_method_invocation_get_object_path(invocation);
+    const char *interface_name = g_dbus_method_invocation_get_interface_name(invocation);
+    const char *method_name = g_dbus_method_invocation_get_method_name(invocation);
+    GVariant *parameters = g_dbus_method_invocation_get_parameters(invocation);
+    GDBusMessage *message = g_dbus_method_invocation_get_message(invocation);
+    
+    // Pass along any fds that came with the call (owned by the incoming message)
+    GUnixFDList *fd_list = g_dbus_message_get_unix_fd_list(message);
+    count_forwarded_fds(fd_list);
+    
+    SourceLane *lane = source_lane_for_call(sender, interface_name, method_name);
+    
+    // Profile methods carry their reply type, so GDBus checks the reply
+    // against it instead of the caller's introspection data
+    const GVariantType *reply_type = NULL;
+    const ProxyProfileMethodInfo *profile_method =
+        proxy_profile_method(g_dbus_method_invocation_get_method_info(invocation));
+    if (profile_method) {
+        reply_type = G_VARIANT_TYPE(profile_method->out_type);
+        count_profile_call(profile_method);
+    }
+    
+    call->cancellable = caller_call_begin(sender);
+    call->started = g_get_monotonic_time();
+    
+    // Forward the call to the source bus
+    g_dbus_connection_call_with_unix_fd_list(
+        source_lane_begin(lane),
+        proxy_state->config.source_bus_name,
+        object_path,
+        interface_name,
+        method_name,
+        parameters,
+        reply_type, // NULL = auto-detect
+        G_DBUS_CALL_FLAGS_NONE,
+        method_timeout_ms(interface_name, method_name),
+        fd_list,
+        call->cancellable,
+        (GAsyncReadyCallback)[](GObject *source, GAsyncResult *res, gpointer user_data) {
+            ForwardedCall *call = (ForwardedCall *)user_data;
+            GDBusMethodInvocation *inv = call->invocation;
+            GUnixFDList *out_fd_list = NULL;
+            GError *error = NULL;
+            GVariant *result = g_dbus_connection_call_with_unix_fd_list_finish(G_DBUS_CONNECTION(source),
+                                                                               &out_fd_list, res, &error);
+            
+            source_lane_end(G_DBUS_CONNECTION(source));
+            caller_call_end(g_dbus_method_invocation_get_sender(inv), call->cancellable);
+            admission_leave(call->started, error);
+            breaker_leave(call->breaker, call->started, breaker_outcome(error, NULL));
+            count_call_latency(call->priority, call->arrived);
+            g_free(call);
+            
+            if (result) {
+                log_verbose("Method call successful, returning result");
+                count_forwarded_fds(out_fd_list);
+                g_dbus_method_invocation_return_value_with_unix_fd_list(inv, result, out_fd_list);
+                g_variant_unref(result);
+                if (out_fd_list) g_object_unref(out_fd_list);
+            } else {
+                count_abandoned_call(error, g_dbus_method_invocation_get_interface_name(inv),
+                                     g_dbus_method_invocation_get_method_name(inv));
+                if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+                    log_error("Method call failed: %s", error ? error->message : "Unknown error");
+                }
+                // Completes the invocation; the bus drops replies to callers that left
+                g_dbus_method_invocation_return_gerror(inv, error);
+                if (error) g_error_free(error);
+            }
+        },
+        call);
+}
+
+// GetManagedObjects reply built from the mirrored objects and the property
+// cache. NULL when some readable property is not cached (opted out of
+// caching, or dropped after a Set), in which case the call is forwarded.
+static GVariant *managed_objects_build()
+{
+    if (!proxy_state->property_cache || proxy_state->config.lazy_objects) return NULL;
+    
+    GVariantBuilder objects;
+    GHashTableIter iter;
+    gpointer key, value;
+    gchar *prefix = g_strcmp0(proxy_state->object_manager_path, "/") == 0
+        ? g_strdup("/") : g_strconcat(proxy_state->object_manager_path, "/", NULL);
+    
+    g_variant_builder_init(&objects, G_VARIANT_TYPE("a{oa{sa{sv}}}"));
+    g_hash_table_iter_init(&iter, proxy_state->objects);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        const char *object_path = (const char *)key;
+        GDBusNodeInfo *node = (GDBusNodeInfo *)value;
+        GVariantBuilder interfaces;
+        
+        if (!g_str_has_prefix(object_path, prefix)) continue;
+        
+        g_variant_builder_init(&interfaces, G_VARIANT_TYPE("a{sa{sv}}"));
+        for (int i = 0; node->interfaces && node->interfaces[i]; i++) {
+            GDBusInterfaceInfo *iface = node->interfaces[i];
+            GVariantBuilder properties;
+            
+            if (g_str_has_prefix(iface->name, "org.freedesktop.DBus.")) continue;
+            
+            g_variant_builder_init(&properties, G_VARIANT_TYPE_VARDICT);
+            guint readable = count_readable_properties(iface->name);
+            if (readable > 0) {
+                PropertyCacheEntry *entry = property_cache_lookup_entry(object_path, iface->name);
+                if (!entry || g_hash_table_size(entry->values) < readable) {
+                    g_variant_builder_clear(&properties);
+                    g_variant_builder_clear(&interfaces);
+                    g_variant_builder_clear(&objects);
+                    g_free(prefix);
+                    return NULL;
+                }
+                
+                GHashTableIter values;
+                gpointer name, property;
+                g_hash_table_iter_init(&values, entry->values);
+                while (g_hash_table_iter_next(&values, &name, &property)) {
+                    g_variant_builder_add(&properties, "{sv}", (const char *)name, (GVariant *)property);
+                }
+            }
+            g_variant_builder_add(&interfaces, "{sa{sv}}", iface->name, &properties);
+        }
+        g_variant_builder_add(&objects, "{oa{sa{sv}}}", object_path, &interfaces);
+    }
+    
+    g_free(prefix);
+    return g_variant_new("(a{oa{sa{sv}}})", &objects);
+}
+
+// Hand a vtable call to its sender's shard, or forward it from the main loop
+static void dispatch_method_call(ForwardedCall *call)
+{
+    ProxyShard *shard = shard_for_key(g_dbus_method_invocation_get_sender(call->invocation));
+    if (shard) {
+        shard_dispatch(shard,
+                       [](gpointer data) -> gboolean {
+                           forward_method_call((ForwardedCall *)data);
+                           return G_SOURCE_REMOVE;
+                       },
+                       call);
+        return;
+    }
+    
+    forward_method_call(call);
+}
+
+// Start tracking a call (one of invocation or message) as it reaches the proxy
+static ForwardedCall *forwarded_call_new(GDBusMethodInvocation *invocation, GDBusMessage *message)
+{
+    ForwardedCall *call = g_new0(ForwardedCall, 1);
+    call->invocation = invocation;
+    call->message = message;
+    call->arrived = g_get_monotonic_time();
+    
+    // Callers leaving while their call waits are noticed too
+    const char *sender = invocation ? g_dbus_method_invocation_get_sender(invocation) : g_dbus_message_get_sender(message);
+    if (sender) name_watch(sender);
+    return call;
+}
+
+static gboolean forward_method_message(gpointer user_data);
+
+// Outage mode: while the source name has no owner, calls are held in
+// arrival order instead of failing with ServiceUnknown, within hold_messages,
+// hold_bytes and hold_timeout_ms. Everything here runs on the main loop,
+// which owns the queue; the owner watch flips source_down.
+static gboolean source_outage()
+{
+    return g_atomic_int_get(&proxy_state->source_down);
+}
+
+static void parked_call_record_hold(ParkedCall *call, gint64 now)
+{
+    guint64 held = (guint64)(now - call->parked);
+    proxy_state->stats.park_time_total_us += held;
+    proxy_state->stats.park_time_max_us = MAX(proxy_state->stats.park_time_max_us, held);
+}
+
+static void parked_call_fail(ParkedCall *call, const char *reason)
+{
+    ForwardedCall *forwarded = call->forwarded;
+    
+    if (forwarded->invocation) {
+        g_dbus_method_invocation_return_dbus_error(forwarded->invocation, "org.freedesktop.DBus.Error.ServiceUnknown",
+                                                   reason);
+    } else {
+        if (!(g_dbus_message_get_flags(forwarded->message) & G_DBUS_MESSAGE_FLAGS_NO_REPLY_EXPECTED)) {
+            GDBusMessage *reply = g_dbus_message_new_method_error_literal(forwarded->message,
+                                                                          "org.freedesktop.DBus.Error.ServiceUnknown",
+                                                                          reason);
+            g_dbus_connection_send_message(proxy_state->target_bus, reply, G_DBUS_SEND_MESSAGE_FLAGS_NONE, NULL, NULL);
+            g_object_unref(reply);
+        }
+        g_object_unref(forwarded->message);
+    }
+    g_free(forwarded);
+    g_free(call);
+}
+
+static void parked_calls_schedule();
+
+// Fail the held calls that reached hold_timeout_ms; the queue is in
+// arrival order, so they are all at its head
+static gboolean on_parked_calls_expired(gpointer user_data G_GNUC_UNUSED)
+{
+    gint64 now = g_get_monotonic_time();
+    gint64 limit = (gint64)proxy_state->config.hold_timeout_ms * 1000;
+    
+    proxy_state->parked_timeout_id = 0;
+    while (!g_queue_is_empty(&proxy_state->parked_calls)) {
+        ParkedCall *call = (ParkedCall *)g_queue_peek_head(&proxy_state->parked_calls);
+        if (now - call->parked < limit) break;
+        
+        g_queue_pop_head(&proxy_state->parked_calls);
+        proxy_state->parked_bytes -= call->bytes;
+        proxy_state->stats.parked_expired++;
+        parked_call_record_hold(call, now);
+        parked_call_fail(call, "Source service did not return within the hold time");
+    }
+    
+    parked_calls_schedule();
+    return G_SOURCE_REMOVE;
+}
+
+// Arm the expiry timer for the oldest held call
+static void parked_calls_schedule()
+{
+    if (proxy_state->parked_timeout_id || g_queue_is_empty(&proxy_state->parked_calls)) return;
+    
+    ParkedCall *oldest = (ParkedCall *)g_queue_peek_head(&proxy_state->parked_calls);
+    gint64 deadline = oldest->parked + (gint64)proxy_state->config.hold_timeout_ms * 1000;
+    gint64 remaining_ms = MAX(0, (deadline - g_get_monotonic_time() + 999) / 1000);
+    proxy_state->parked_timeout_id = g_timeout_add((guint)remaining_ms, on_parked_calls_expired, NULL);
+}
+
+// Hold a call if the source is down. Returns FALSE when it is not, and the
+// caller forwards the call itself.
+static gboolean park_call(ForwardedCall *forwarded)
+{
+    if (!source_outage()) return FALSE;
+    
+    GVariant *body = forwarded->invocation ? g_dbus_method_invocation_get_parameters(forwarded->invocation)
+                                           : g_dbus_message_get_body(forwarded->message);
+    ParkedCall *call = g_new0(ParkedCall, 1);
+    call->forwarded = forwarded;
+    call->bytes = body ? g_variant_get_size(body) : 0;
+    call->parked = g_get_monotonic_time();
+    
+    if (g_queue_get_length(&proxy_state->parked_calls) >= proxy_state->config.hold_messages ||
+        (proxy_state->config.hold_bytes && proxy_state->parked_bytes + call->bytes > proxy_state->config.hold_bytes)) {
+        proxy_state->stats.parked_rejected++;
+        parked_call_fail(call, "Source service unavailable and the hold queue is full");
+        return TRUE;
+    }
+    
+    g_queue_push_tail(&proxy_state->parked_calls, call);
+    proxy_state->parked_bytes += call->bytes;
+    proxy_state->stats.calls_parked++;
+    proxy_state->stats.parked_max_depth = MAX(proxy_state->stats.parked_max_depth,
+                                              g_queue_get_length(&proxy_state->parked_calls));
+    parked_calls_schedule();
+    return TRUE;
+}
+
+// Forward the held calls in the order they arrived
+static void parked_calls_replay()
+{
+    gint64 now = g_get_monotonic_time();
+    ParkedCall *call;
+    
+    if (proxy_state->parked_timeout_id) {
+        g_source_remove(proxy_state->parked_timeout_id);
+        proxy_state->parked_timeout_id = 0;
+    }
+    
+    while ((call = (ParkedCall *)g_queue_pop_head(&proxy_state->parked_calls))) {
+        proxy_state->stats.parked_replayed++;
+        parked_call_record_hold(call, now);
+        if (call->forwarded->invocation) {
+            dispatch_method_call(call->forwarded);
+        } else {
+            shard_dispatch(shard_for_key(g_dbus_message_get_sender(call->forwarded->message)), forward_method_message,
+                           call->forwarded);
+        }
+        g_free(call);
+    }
+    proxy_state->parked_bytes = 0;
+}
+
+// Forward method calls from target bus to source bus
+static void handle_method_call(GDBusConnection *connection G_GNUC_UNUSED,
+                               const char *sender,
+                               const char *object_path,
+                               const char *interface_name,
+                               const char *method_name,
+                               GVariant *parameters,
+                               GDBusMethodInvocation *invocation,
+                               gpointer user_data G_GNUC_UNUSED)
+{
+    // Property access stays on the main loop, which owns the property cache
+    if (g_strcmp0(interface_name, "org.freedesktop.DBus.Properties") == 0) {
+        handle_properties_call(sender, object_path, method_name, parameters, invocation);
+        return;
+    }
+    
+    // The mirror already holds what GetManagedObjects would return
+    if (proxy_state->object_manager_path &&
+        g_strcmp0(object_path, proxy_state->object_manager_path) == 0 &&
+        g_strcmp0(interface_name, "org.freedesktop.DBus.ObjectManager") == 0 &&
+        g_strcmp0(method_name, "GetManagedObjects") == 0) {
+        GVariant *reply = managed_objects_build();
+        if (reply) {
+            proxy_state->stats.managed_objects_served++;
+            g_dbus_method_invocation_return_value(invocation, reply);
+            return;
+        }
+    }
+    
+    ForwardedCall *call = forwarded_call_new(invocation, NULL);
+    if (park_call(call)) return;
+    dispatch_method_call(call);
+}
+
+// Relay the source reply of a message-level forwarded call back to the caller
+static void on_forwarded_message_reply(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    ForwardedCall *forwarded = (ForwardedCall *)user_data;
+    GDBusMessage *call = forwarded->message;
+    GError *error = NULL;
+    GDBusMessage *reply = g_dbus_connection_send_message_with_reply_finish(G_DBUS_CONNECTION(source), res, &error);
+    GDBusMessage *out;
+    
+    source_lane_end(G_DBUS_CONNECTION(source));
+    caller_call_end(g_dbus_message_get_sender(call), forwarded->cancellable);
+    admission_leave(forwarded->started, error);
+    breaker_leave(forwarded->breaker, forwarded->started,
+                  breaker_outcome(error, reply && g_dbus_message_get_message_type(reply) == G_DBUS_MESSAGE_TYPE_ERROR
+                                  ? g_dbus_message_get_error_name(reply) : NULL));
+    count_call_latency(forwarded->priority, forwarded->arrived);
+    g_free(forwarded);
+    
+    if (reply) {
+        // Reuse the reply body as-is; only the header is rebuilt for the caller
+        out = g_dbus_message_new_method_reply(call);
+        if (g_dbus_message_get_message_type(reply) == G_DBUS_MESSAGE_TYPE_ERROR) {
+            g_dbus_message_set_message_type(out, G_DBUS_MESSAGE_TYPE_ERROR);
+            g_dbus_message_set_error_name(out, g_dbus_message_get_error_name(reply));
+            log_verbose("Forwarded call %s.%s returned error %s",
+                        g_dbus_message_get_interface(call), g_dbus_message_get_member(call),
+                        g_dbus_message_get_error_name(reply));
+        }
+        g_dbus_message_set_body(out, g_dbus_message_get_body(reply));
+        g_dbus_message_set_unix_fd_list(out, g_dbus_message_get_unix_fd_list(reply));
+        count_forwarded_fds(g_dbus_message_get_unix_fd_list(reply));
+        g_object_unref(reply);
+    } else {
+        count_abandoned_call(error, g_dbus_message_get_interface(call), g_dbus_message_get_member(call));
+        if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+            log_error("Method call failed: %s", error->message);
+        }
+        gchar *error_name = g_dbus_error_encode_gerror(error);
+        out = g_dbus_message_new_method_error_literal(call, error_name, error->message);
+        g_free(error_name);
+        g_error_free(error);
+    }
+    
+    if (!g_dbus_connection_send_message(proxy_state->target_bus, out, G_DBUS_SEND_MESSAGE_FLAGS_NONE, NULL, &error)) {
+        log_error("Failed to relay reply: %s", error->message);
+        g_error_free(error);
+    }
+    
+    g_object_unref(out);
+    g_object_unref(call);
+}
+
+// Forward a method call taken off the target bus by the message filter.
+// The header is rewritten for the source (destination, path; the serial is
+// assigned on send) and the already-parsed body is attached by reference.
+static gboolean forward_method_message(gpointer user_data)
+{
+    ForwardedCall *forwarded = (ForwardedCall *)user_data;
+    GDBusMessage *call = forwarded->message;
+    const char *interface_name = g_dbus_message_get_interface(call);
+    const char *method_name = g_dbus_message_get_member(call);
+    
+    // May run on a shard while the main loop changes the mirror
+    GDBusInterfaceInfo *iface = lookup_interface_info_ref(interface_name);
+    GDBusMethodInfo *method = iface ? g_dbus_interface_info_lookup_method(iface, method_name) : NULL;
+    // Profile infos are static and outlive the reference
+    const ProxyProfileMethodInfo *profile_method = proxy_profile_method(method);
+    forwarded->profile_method = profile_method;
+    if (iface) g_dbus_interface_info_unref(iface);
+    
+    // Unlike the vtable path, nothing has checked the arguments yet; profile
+    // methods have their in type at hand
+    GDBusMessage *error_reply = NULL;
+    if (!method) {
+        error_reply = g_dbus_message_new_method_error(call, "org.freedesktop.DBus.Error.UnknownMethod",
+                                                      "No such method %s.%s", interface_name, method_name);
+    } else if (profile_method) {
+        GVariant *body = g_dbus_message_get_body(call);
+        if (body ? !g_variant_is_of_type(body, G_VARIANT_TYPE(profile_method->in_type))
+                 : g_strcmp0(profile_method->in_type, "()") != 0) {
+            error_reply = g_dbus_message_new_method_error(call, "org.freedesktop.DBus.Error.InvalidArgs",
+                                                          "Type of message, \"%s\", does not match expected type \"%s\"",
+                                                          body ? g_variant_get_type_string(body) : "()",
+                                                          profile_method->in_type);
+        }
+    }
+    if (error_reply) {
+        g_dbus_connection_send_message(proxy_state->target_bus, error_reply, G_DBUS_SEND_MESSAGE_FLAGS_NONE, NULL, NULL);
+        g_object_unref(error_reply);
+        g_object_unref(call);
+        g_free(forwarded);
+        return G_SOURCE_REMOVE;
+    }
+    
+    // The hold queue belongs to the main loop; shards hand calls over to it
+    if (source_outage()) {
+        if (current_shard) {
+            shard_dispatch(NULL,
+                           [](gpointer data) -> gboolean {
+                               ForwardedCall *forwarded = (ForwardedCall *)data;
+                               if (!park_call(forwarded)) {
+                                   shard_dispatch(shard_for_key(g_dbus_message_get_sender(forwarded->message)),
+                                                  forward_method_message, forwarded);
+                               }
+                               return G_SOURCE_REMOVE;
+                           },
+                           forwarded);
+            return G_SOURCE_REMOVE;
+        }
+        if (park_call(forwarded)) return G_SOURCE_REMOVE;
+    }
+    
+    log_verbose("Method call (message): %s.%s from %s", interface_name, method_name, g_dbus_message_get_sender(call));
+    shard_stats()->message_calls_forwarded++;
+    
+    if (g_dbus_message_get_flags(call) & G_DBUS_MESSAGE_FLAGS_NO_REPLY_EXPECTED) {
+        forward_one_way_call(call);
+        g_object_unref(call);
+        g_free(forwarded);
+        return G_SOURCE_REMOVE;
+    }
+    
+    forwarded->breaker = breaker_enter();
+    if (forwarded->breaker == BREAKER_REJECT) {
+        admission_fail(forwarded, proxy_state->breaker_error, BREAKER_OPEN_MESSAGE);
+        return G_SOURCE_REMOVE;
+    }
+    
+    forwarded->priority = message_priority(g_dbus_message_get_sender(call), interface_name, method_name);
+    switch (admission_enter(forwarded)) {
+    case ADMISSION_ADMITTED:
+        forward_method_message_admitted(forwarded);
+        break;
+    case ADMISSION_QUEUED:
+        break;
+    case ADMISSION_REJECTED:
+        breaker_leave(forwarded->breaker, 0, BREAKER_NO_SAMPLE);
+        admission_fail(forwarded, ADMISSION_REJECTED_ERROR, ADMISSION_REJECTED_MESSAGE);
+        break;
+    }
+    return G_SOURCE_REMOVE;
+}
+
+// Second half of forward_method_message, once the call holds an in-flight slot
+static void forward_method_message_admitted(ForwardedCall *forwarded)
+{
+    GDBusMessage *call = forwarded->message;
+    const char *interface_name = g_dbus_message_get_interface(call);
+    const char *method_name = g_dbus_message_get_member(call);
+    
+    GDBusMessage *upstream = g_dbus_message_new_method_call(proxy_state->config.source_bus_name,
+                                                            g_dbus_message_get_path(call),
+                                                            interface_name,
+                                                            method_name);
+    g_dbus_message_set_flags(upstream, g_dbus_message_get_flags(call));
+    g_dbus_message_set_body(upstream, g_dbus_message_get_body(call));
+    g_dbus_message_set_unix_fd_list(upstream, g_dbus_message_get_unix_fd_list(call));
+    count_forwarded_fds(g_dbus_message_get_unix_fd_list(call));
+    
+    SourceLane *lane = source_lane_for_call(g_dbus_message_get_sender(call), interface_name, method_name);
+    
+    if (forwarded->profile_method) count_profile_call(forwarded->profile_method);
+    
+    forwarded->cancellable = caller_call_begin(g_dbus_message_get_sender(call));
+    forwarded->started = g_get_monotonic_time();
+    
+    g_dbus_connection_send_message_with_reply(
+        source_lane_begin(lane),
+        upstream,
+        G_DBUS_SEND_MESSAGE_FLAGS_NONE,
+        method_timeout_ms(interface_name, method_name),
+        NULL, // Out serial
+        forwarded->cancellable,
+        on_forwarded_message_reply,
+        forwarded);
+    
+    g_object_unref(upstream);
+}
+
+// Target bus filter for the message-level engine. Runs in the GDBus worker
+// thread, so it only claims matching method calls and hands them over to the
+// main loop. Standard org.freedesktop.DBus.* interfaces (Properties,
+// Introspectable, Peer) stay with the registered vtable.
+static GDBusMessage *message_forwarding_filter(GDBusConnection *connection G_GNUC_UNUSED,
+                                               GDBusMessage *message,
+                                               gboolean incoming,
+                                               gpointer user_data G_GNUC_UNUSED)
+{
+    if (!incoming || g_dbus_message_get_message_type(message) != G_DBUS_MESSAGE_TYPE_METHOD_CALL) {
+        return message;
+    }
+    
+    const char *interface_name = g_dbus_message_get_interface(message);
+    if (!interface_name || g_str_has_prefix(interface_name, "org.freedesktop.DBus.")) {
+        return message;
+    }
+    
+    if (!object_is_mirrored(g_dbus_message_get_path(message))) {
+        return message;
+    }
+    
+    shard_dispatch(shard_for_key(g_dbus_message_get_sender(message)), forward_method_message,
+                   forwarded_call_new(NULL, message));
+    return NULL;
+}
+
+// Whether a D-Bus signature carries unix fds ('h' is only used for UNIX_FD)
+static gboolean signature_has_fds(const char *signature)
+{
+    return signature && strchr(signature, 'h') != NULL;
+}
+
+// A signal waiting to be emitted on the target bus
+typedef struct {
+    gchar *object_path;
+    gchar *interface_name;
+    gchar *signal_name;
+    GVariant *parameters;
+    GUnixFDList *fd_list; // Fds the signal carries, NULL for most
+    PriorityClass priority;
+    gint64 queued_at;     // Monotonic time it entered the signal queue
+} SignalEmission;
+
+static SignalEmission *signal_emission_new(const char *object_path,
+                                           const char *interface_name,
+                                           const char *signal_name,
+                                           GVariant *parameters)
+{
+    SignalEmission *emission = g_new0(SignalEmission, 1);
+    emission->object_path = g_strdup(object_path);
+    emission->interface_name = g_strdup(interface_name);
+    emission->signal_name = g_strdup(signal_name);
+    emission->parameters = g_variant_ref(parameters);
+    return emission;
+}
+
+static void signal_emission_free(SignalEmission *emission)
+{
+    g_free(emission->object_path);
+    g_free(emission->interface_name);
+    g_free(emission->signal_name);
+    g_variant_unref(emission->parameters);
+    if (emission->fd_list) g_object_unref(emission->fd_list);
+    g_free(emission);
+}
+
+// Emit a forwarded signal on the target bus and free it
+static void signal_emission_send(SignalEmission *emission)
+{
+    GError *error = NULL;
+    gboolean success;
+    
+    if (emission->fd_list) {
+        // emit_signal cannot pass fds; build the message to attach them
+        GDBusMessage *out = g_dbus_message_new_signal(emission->object_path,
+                                                      emission->interface_name,
+                                                      emission->signal_name);
+        g_dbus_message_set_body(out, emission->parameters);
+        g_dbus_message_set_unix_fd_list(out, emission->fd_list);
+        count_forwarded_fds(emission->fd_list);
+        success = g_dbus_connection_send_message(proxy_state->target_bus, out, G_DBUS_SEND_MESSAGE_FLAGS_NONE,
+                                                 NULL, &error);
+        g_object_unref(out);
+    } else {
+        success = g_dbus_connection_emit_signal(
+            proxy_state->target_bus,
+            NULL, // Broadcast to all subscribers
+            emission->object_path,
+            emission->interface_name,
+            emission->signal_name,
+            emission->parameters,
+            &error);
+    }
+    
+    if (success) {
+        log_verbose("Signal forwarded successfully");
+    } else {
+        log_error("Failed to forward signal: %s", error ? error->message : "Unknown error");
+        if (error) g_error_free(error);
+    }
+    
+    signal_emission_free(emission);
+}
+
+// Signals handed to GDBus per batch before waiting for them to be written
+#define SIGNAL_QUEUE_BATCH 32
+
+// Signal queue of the calling thread
+static SignalQueue *current_signal_queue()
+{
+    return current_shard ? &current_shard->signal_queue : &proxy_state->signal_queue;
+}
+
+static void signal_queue_init(SignalQueue *q)
+{
+    for (guint c = 0; c < PRIORITY_CLASSES; c++) g_queue_init(&q->queues[c]);
+    q->by_key = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+}
+
+static void signal_queue_clear(SignalQueue *q)
+{
+    SignalEmission *emission;
+    for (guint c = 0; c < PRIORITY_CLASSES; c++) {
+        while ((emission = (SignalEmission *)g_queue_pop_head(&q->queues[c]))) {
+            signal_emission_free(emission);
+        }
+    }
+    if (q->by_key) g_hash_table_destroy(q->by_key);
+    q->by_key = NULL;
+    q->length = 0;
+    q->bytes = 0;
+}
+
+// Coalescing key, or NULL. Only PropertiesChanged for one interface is
+// superseded by a later one; any other payload (a second InterfacesAdded,
+// say) carries its own news and is never merged away.
+static gchar *signal_emission_key(SignalEmission *emission)
+{
+    const char *changed_interface;
+    
+    if (g_strcmp0(emission->signal_name, "PropertiesChanged") != 0 ||
+        g_strcmp0(emission->interface_name, "org.freedesktop.DBus.Properties") != 0 ||
+        !g_variant_is_of_type(emission->parameters, G_VARIANT_TYPE("(sa{sv}as)"))) {
+        return NULL;
+    }
+    g_variant_get_child(emission->parameters, 0, "&s", &changed_interface);
+    return g_strdup_printf("%s %s %s %s", emission->object_path, emission->interface_name,
+                           emission->signal_name, changed_interface);
+}
+
+// Merge two PropertiesChanged payloads for the same interface; for each
+// property the newer change or invalidation wins
+static GVariant *merge_properties_changed(GVariant *older, GVariant *newer)
+{
+    const char *interface_name, *name;
+    GVariant *newer_changed, *older_changed, *value;
+    const char **newer_invalidated, **older_invalidated;
+    GVariantBuilder changed, invalidated;
+    GVariantIter iter;
+    
+    g_variant_get(newer, "(&s@a{sv}^a&s)", &interface_name, &newer_changed, &newer_invalidated);
+    g_variant_get(older, "(&s@a{sv}^a&s)", NULL, &older_changed, &older_invalidated);
+    
+    g_variant_builder_init(&changed, G_VARIANT_TYPE_VARDICT);
+    g_variant_builder_init(&invalidated, G_VARIANT_TYPE_STRING_ARRAY);
+    
+    g_variant_iter_init(&iter, older_changed);
+    while (g_variant_iter_next(&iter, "{&sv}", &name, &value)) {
+        GVariant *replaced = g_variant_lookup_value(newer_changed, name, NULL);
+        if (!replaced && !g_strv_contains(newer_invalidated, name)) {
+            g_variant_builder_add(&changed, "{sv}", name, value);
+        }
+        if (replaced) g_variant_unref(replaced);
+        g_variant_unref(value);
+    }
+    g_variant_iter_init(&iter, newer_changed);
+    while (g_variant_iter_next(&iter, "{&sv}", &name, &value)) {
+        g_variant_builder_add(&changed, "{sv}", name, value);
+        g_variant_unref(value);
+    }
+    
+    for (int i = 0; older_invalidated[i]; i++) {
+        GVariant *replaced = g_variant_lookup_value(newer_changed, older_invalidated[i], NULL);
+        if (!replaced && !g_strv_contains(newer_invalidated, older_invalidated[i])) {
+            g_variant_builder_add(&invalidated, "s", older_invalidated[i]);
+        }
+        if (replaced) g_variant_unref(replaced);
+    }
+    for (int i = 0; newer_invalidated[i]; i++) {
+        g_variant_builder_add(&invalidated, "s", newer_invalidated[i]);
+    }
+    
+    GVariant *merged = g_variant_ref_sink(g_variant_new("(sa{sv}as)", interface_name, &changed, &invalidated));
+    
+    g_variant_unref(newer_changed);
+    g_variant_unref(older_changed);
+    g_free(newer_invalidated);
+    g_free(older_invalidated);
+    return merged;
+}
+
+// Take a queued signal out of the queue's accounting (and coalescing index)
+static void signal_queue_unlink(SignalQueue *q, SignalEmission *emission)
+{
+    q->length--;
+    q->bytes -= g_variant_get_size(emission->parameters);
+    if (proxy_state->config.signal_queue_policy == SIGNAL_QUEUE_COALESCE) {
+        gchar *key = signal_emission_key(emission);
+        if (key && g_hash_table_lookup(q->by_key, key) == emission) g_hash_table_remove(q->by_key, key);
+        g_free(key);
+    }
+}
+
+// Pop the oldest queued signal of the class picked by priority_pick() and
+// hand it to GDBus
+static void signal_queue_emit_head(SignalQueue *q)
+{
+    ProxyStats *stats = shard_stats();
+    gboolean ready[PRIORITY_CLASSES];
+    for (guint c = 0; c < PRIORITY_CLASSES; c++) ready[c] = !g_queue_is_empty(&q->queues[c]);
+    guint priority = priority_pick(ready, q->passed_over);
+    SignalEmission *emission = (SignalEmission *)g_queue_pop_head(&q->queues[priority]);
+    signal_queue_unlink(q, emission);
+    
+    guint64 latency = g_get_monotonic_time() - emission->queued_at;
+    stats->signal_latency_total_us += latency;
+    stats->signal_latency_max_us = MAX(stats->signal_latency_max_us, latency);
+    stats->signal_latency[emission->priority][latency_bucket(latency)]++;
+    stats->signals_emitted++;
+    
+    signal_emission_send(emission);
+}
+
+static void signal_queue_pump(SignalQueue *q);
+
+// A batch has been written to the target bus; send the next one
+static void on_signal_batch_flushed(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    SignalQueue *q = (SignalQueue *)user_data;
+    GError *error = NULL;
+    
+    if (!g_dbus_connection_flush_finish(G_DBUS_CONNECTION(source), res, &error)) {
+        log_error("Failed to flush target bus: %s", error->message);
+        g_error_free(error);
+    }
+    
+    q->flushing = FALSE;
+    signal_queue_pump(q);
+}
+
+// Hand the next batch of queued signals to GDBus
+static void signal_queue_pump(SignalQueue *q)
+{
+    if (q->flushing || q->length == 0) return;
+    
+    for (guint i = 0; i < SIGNAL_QUEUE_BATCH && q->length > 0; i++) {
+        signal_queue_emit_head(q);
+    }
+    
+    q->flushing = TRUE;
+    g_dbus_connection_flush(proxy_state->target_bus, NULL, on_signal_batch_flushed, q);
+}
+
+static gboolean signal_queue_over_budget(SignalQueue *q)
+{
+    return q->length > proxy_state->config.signal_queue_messages ||
+           (proxy_state->config.signal_queue_bytes > 0 && q->bytes > proxy_state->config.signal_queue_bytes);
+}
+
+// Queue a forwarded signal, applying the configured policy when over budget
+static void signal_queue_push(SignalQueue *q, SignalEmission *emission)
+{
+    ProxyStats *stats = shard_stats();
+    
+    emission->queued_at = g_get_monotonic_time();
+    emission->priority = message_priority(NULL, emission->interface_name, emission->signal_name);
+    GQueue *queue = &q->queues[emission->priority];
+    gchar *key = proxy_state->config.signal_queue_policy == SIGNAL_QUEUE_COALESCE
+        ? signal_emission_key(emission) : NULL;
+    
+    if (key) {
+        SignalEmission *queued = (SignalEmission *)g_hash_table_lookup(q->by_key, key);
+        gsize size = g_variant_get_size(emission->parameters);
+        gboolean fits = q->length < proxy_state->config.signal_queue_messages &&
+                        (proxy_state->config.signal_queue_bytes == 0 ||
+                         q->bytes + size <= proxy_state->config.signal_queue_bytes);
+        
+        // Only when the signal would not fit: fold it into the newest queued
+        // change of the same interface, so nothing queued after that one
+        // could be overtaken by older values
+        if (queued && !fits) {
+            GVariant *parameters = merge_properties_changed(queued->parameters, emission->parameters);
+            
+            q->bytes -= g_variant_get_size(queued->parameters);
+            g_variant_unref(queued->parameters);
+            queued->parameters = parameters;
+            q->bytes += g_variant_get_size(queued->parameters);
+            
+            stats->signals_coalesced++;
+            signal_emission_free(emission);
+            g_free(key);
+            signal_queue_pump(q);
+            return;
+        }
+        
+        g_hash_table_replace(q->by_key, key, emission);
+    }
+    g_queue_push_tail(queue, emission);
+    q->length++;
+    q->bytes += g_variant_get_size(emission->parameters);
+    
+    stats->signal_queue_max_depth = MAX(stats->signal_queue_max_depth, q->length);
+    
+    while (signal_queue_over_budget(q)) {
+        if (proxy_state->config.signal_queue_policy == SIGNAL_QUEUE_BLOCK) {
+            // GDBus reads sockets on its own thread, so this stalls dispatch of
+            // upstream traffic on this loop rather than the socket itself
+            stats->signal_queue_blocked++;
+            g_dbus_connection_flush_sync(proxy_state->target_bus, NULL, NULL);
+            signal_queue_emit_head(q);
+            continue;
+        }
+        
+        // The oldest signal of the lowest class goes first
+        SignalEmission *oldest = NULL;
+        for (guint c = PRIORITY_CLASSES; c-- > 0 && !oldest;) {
+            oldest = (SignalEmission *)g_queue_pop_head(&q->queues[c]);
+        }
+        signal_queue_unlink(q, oldest);
+        log_verbose("Signal queue full, dropping %s.%s", oldest->interface_name, oldest->signal_name);
+        stats->signals_dropped++;
+        signal_emission_free(oldest);
+    }
+    
+    signal_queue_pump(q);
+}
+
+// Emit a forwarded signal, through the bounded queue when one is configured
+static gboolean emit_forwarded_signal(gpointer user_data)
+{
+    SignalEmission *emission = (SignalEmission *)user_data;
+    
+    if (proxy_state->config.signal_queue_messages > 0) {
+        signal_queue_push(current_signal_queue(), emission);
+    } else {
+        signal_emission_send(emission);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+// Emit a forwarded signal from the shard owning its object path, which
+// keeps per-object ordering, or from the main loop
+static void dispatch_forwarded_signal(SignalEmission *emission)
+{
+    ProxyShard *shard = shard_for_key(emission->object_path);
+    if (shard) {
+        shard_dispatch(shard, emit_forwarded_signal, emission);
+        return;
+    }
+    
+    emit_forwarded_signal(emission);
+}
+
+// Forward signals from source bus to target bus
+static void on_signal_received(GDBusConnection *connection G_GNUC_UNUSED,
+                               const char *sender_name,
+                               const char *object_path,
+                               const char *interface_name,
+                               const char *signal_name,
+                               GVariant *parameters,
+                               gpointer user_data G_GNUC_UNUSED)
+{
+    log_verbose("Signal received: %s.%s from %s", interface_name, signal_name, sender_name);
+    dispatch_forwarded_signal(signal_emission_new(object_path, interface_name, signal_name, parameters));
+}
+
+static void pending_properties_free(gpointer data)
+{
+    PendingPropertiesChanged *pending = (PendingPropertiesChanged *)data;
+    
+    if (pending->timeout_id) g_source_remove(pending->timeout_id);
+    g_free(pending->object_path);
+    g_free(pending->interface_name);
+    g_hash_table_destroy(pending->changed);
+    g_hash_table_destroy(pending->invalidated);
+    g_free(pending);
+}
+
+// Emit the combined PropertiesChanged once the coalescing window closes.
+// The window is not extended by later signals, so the added latency is
+// bounded by the configured window.
+static gboolean flush_pending_properties(gpointer user_data)
+{
+    PendingPropertiesChanged *pending = (PendingPropertiesChanged *)user_data;
+    GVariantBuilder changed, invalidated;
+    GHashTableIter iter;
+    gpointer key, value;
+    
+    g_variant_builder_init(&changed, G_VARIANT_TYPE_VARDICT);
+    g_hash_table_iter_init(&iter, pending->changed);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        g_variant_builder_add(&changed, "{sv}", (const char *)key, (GVariant *)value);
+    }
+    
+    g_variant_builder_init(&invalidated, G_VARIANT_TYPE_STRING_ARRAY);
+    g_hash_table_iter_init(&iter, pending->invalidated);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        g_variant_builder_add(&invalidated, "s", (const char *)key);
+    }
+    
+    GVariant *parameters = g_variant_ref_sink(g_variant_new("(sa{sv}as)", pending->interface_name,
+                                                            &changed, &invalidated));
+    
+    guint64 delay = g_get_monotonic_time() - pending->first_seen;
+    proxy_state->stats.properties_changed_flushed++;
+    proxy_state->stats.coalesce_max_delay_us = MAX(proxy_state->stats.coalesce_max_delay_us, delay);
+    
+    // The source is gone once the callback returns; stop the table from removing it again
+    pending->timeout_id = 0;
+    on_signal_received(NULL, proxy_state->config.source_bus_name, pending->object_path,
+                       "org.freedesktop.DBus.Properties", "PropertiesChanged", parameters, NULL);
+    g_variant_unref(parameters);
+    
+    gchar *table_key = g_strconcat(pending->object_path, " ", pending->interface_name, NULL);
+    g_hash_table_remove(proxy_state->pending_properties, table_key);
+    g_free(table_key);
+    return G_SOURCE_REMOVE;
+}
+
+// Fold a PropertiesChanged into the pending one for its object and interface.
+// A later change of a property replaces an earlier value or invalidation and
+// vice versa; everything else is merged.
+static void coalesce_properties_changed(const char *object_path, GVariant *parameters, guint window_ms)
+{
+    const char *interface_name;
+    GVariantIter *changed, *invalidated;
+    const char *name;
+    GVariant *value;
+    
+    g_variant_get(parameters, "(&sa{sv}as)", &interface_name, &changed, &invalidated);
+    
+    gchar *key = g_strconcat(object_path, " ", interface_name, NULL);
+    PendingPropertiesChanged *pending =
+        (PendingPropertiesChanged *)g_hash_table_lookup(proxy_state->pending_properties, key);
+    
+    if (pending) {
+        proxy_state->stats.properties_changed_merged++;
+        g_free(key);
+    } else {
+        pending = g_new0(PendingPropertiesChanged, 1);
+        pending->object_path = g_strdup(object_path);
+        pending->interface_name = g_strdup(interface_name);
+        pending->changed = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_variant_unref);
+        pending->invalidated = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+        pending->first_seen = g_get_monotonic_time();
+        pending->timeout_id = g_timeout_add(window_ms, flush_pending_properties, pending);
+        g_hash_table_insert(proxy_state->pending_properties, key, pending);
+    }
+    
+    while (g_variant_iter_next(changed, "{&sv}", &name, &value)) {
+        g_hash_table_remove(pending->invalidated, name);
+        g_hash_table_replace(pending->changed, g_strdup(name), value);
+    }
+    while (g_variant_iter_next(invalidated, "&s", &name)) {
+        g_hash_table_remove(pending->changed, name);
+        g_hash_table_add(pending->invalidated, g_strdup(name));
+    }
+    
+    g_variant_iter_free(changed);
+    g_variant_iter_free(invalidated);
+}
+
+// Handle properties changed signals specially
+static void on_properties_changed(GDBusConnection *connection,
+                                  const char *sender_name,
+                                  const char *object_path,
+                                  const char *interface_name,
+                                  const char *signal_name,
+                                  GVariant *parameters,
+                                  gpointer user_data)
+{
+    const char *changed_interface;
+    g_variant_get_child(parameters, 0, "&s", &changed_interface);
+    
+    log_verbose("Properties changed signal for interface: %s", changed_interface);
+    
+    property_cache_apply_changes(object_path, parameters);
+    
+    if (proxy_state->pending_properties) {
+        guint window_ms = GPOINTER_TO_UINT(g_hash_table_lookup(proxy_state->config.coalesce_windows,
+                                                               changed_interface));
+        if (window_ms > 0) {
+            coalesce_properties_changed(object_path, parameters, window_ms);
+            return;
+        }
+    }
+    
+    // Forward the PropertiesChanged signal
+    on_signal_received(connection, sender_name, object_path, interface_name, signal_name, parameters, user_data);
+}
+
+static void signal_subscription_free(gpointer data)
+{
+    SignalSubscription *sub = (SignalSubscription *)data;
+    
+    g_free(sub->object_path);
+    g_free(sub->interface_name);
+    g_free(sub->signal_name);
+    g_free(sub);
+}
+
+// Add (path, interface, member) to the signal index; duplicates collapse
+// into the existing entry. Returns TRUE if the entry is new.
+static gboolean signal_subscription_add(const char *object_path, const char *interface_name,
+                                        const char *signal_name)
+{
+    gchar *key = g_strconcat(object_path, " ", interface_name, " ", signal_name, NULL);
+    
+    if (g_hash_table_contains(proxy_state->signal_subscriptions, key)) {
+        log_verbose("Signal %s.%s on %s already forwarded, not subscribing twice",
+                    interface_name, signal_name, object_path);
+        g_free(key);
+        return FALSE;
+    }
+    
+    SignalSubscription *sub = g_new0(SignalSubscription, 1);
+    sub->object_path = g_strdup(object_path);
+    sub->interface_name = g_strdup(interface_name);
+    sub->signal_name = g_strdup(signal_name);
+    g_hash_table_insert(proxy_state->signal_subscriptions, key, sub);
+    return TRUE;
+}
+
+static gboolean on_object_manager_signal(const char *signal_name, GVariant *parameters);
+
+// Index entry of a source signal, NULL if it is not forwarded. Lazy mode
+// indexes a declared signal the first time a mirrored object sends it.
+static SignalSubscription *signal_subscription_lookup(const char *object_path, const char *interface_name,
+                                                      const char *signal_name)
+{
+    gchar *key = g_strconcat(object_path, " ", interface_name, " ", signal_name, NULL);
+    SignalSubscription *sub = (SignalSubscription *)g_hash_table_lookup(proxy_state->signal_subscriptions, key);
+    g_free(key);
+    
+    if (!sub && proxy_state->config.lazy_objects && g_hash_table_contains(proxy_state->objects, object_path)) {
+        GDBusInterfaceInfo *iface = lookup_interface_info(interface_name);
+        gboolean declared = (iface && g_dbus_interface_info_lookup_signal(iface, signal_name)) ||
+                            (g_strcmp0(interface_name, "org.freedesktop.DBus.Properties") == 0 &&
+                             g_strcmp0(signal_name, "PropertiesChanged") == 0);
+        if (declared) {
+            signal_subscription_add(object_path, interface_name, signal_name);
+            key = g_strconcat(object_path, " ", interface_name, " ", signal_name, NULL);
+            sub = (SignalSubscription *)g_hash_table_lookup(proxy_state->signal_subscriptions, key);
+            g_free(key);
+        }
+    }
+    return sub;
+}
+
+// Dispatch a signal from the source's wildcard subscription. Only
+// PropertiesChanged and signals declared in the introspection data are
+// forwarded.
+static void on_source_signal(GDBusConnection *connection,
+                             const char *sender_name,
+                             const char *object_path,
+                             const char *interface_name,
+                             const char *signal_name,
+                             GVariant *parameters,
+                             gpointer user_data)
+{
+    // Signals with fds are relayed by fd_signal_filter
+    if (signature_has_fds(g_variant_get_type_string(parameters))) return;
+    
+    SignalSubscription *sub = signal_subscription_lookup(object_path, interface_name, signal_name);
+    if (!sub) {
+        log_verbose("Ignoring undeclared signal %s.%s on %s", interface_name, signal_name, object_path);
+        return;
+    }
+    sub->forwarded++;
+    
+    if (proxy_state->object_manager_path &&
+        g_strcmp0(object_path, proxy_state->object_manager_path) == 0 &&
+        g_strcmp0(interface_name, "org.freedesktop.DBus.ObjectManager") == 0 &&
+        on_object_manager_signal(signal_name, parameters)) {
+        return;
+    }
+    
+    if (g_strcmp0(interface_name, "org.freedesktop.DBus.Properties") == 0 &&
+        g_strcmp0(signal_name, "PropertiesChanged") == 0) {
+        on_properties_changed(connection, sender_name, object_path, interface_name, signal_name, parameters, user_data);
+        return;
+    }
+    
+    on_signal_received(connection, sender_name, object_path, interface_name, signal_name, parameters, user_data);
+}
+
+// Relay a signal carrying fds, taken off the source bus by fd_signal_filter.
+// Like on_source_signal, only signals of the current source owner that are
+// in the signal index get through; they are then emitted like any other
+// forwarded signal, with their fd list. Runs on the main loop.
+static gboolean forward_fd_signal(gpointer user_data)
+{
+    GDBusMessage *message = (GDBusMessage *)user_data;
+    const char *sender = g_dbus_message_get_sender(message);
+    const char *object_path = g_dbus_message_get_path(message);
+    const char *interface_name = g_dbus_message_get_interface(message);
+    const char *signal_name = g_dbus_message_get_member(message);
+    
+    if (!proxy_state->source_owner || g_strcmp0(sender, proxy_state->source_owner) != 0) {
+        log_verbose("Ignoring signal %s.%s with fds from %s, not the source", interface_name, signal_name, sender);
+        g_object_unref(message);
+        return G_SOURCE_REMOVE;
+    }
+    
+    SignalSubscription *sub = signal_subscription_lookup(object_path, interface_name, signal_name);
+    if (!sub) {
+        log_verbose("Ignoring undeclared signal %s.%s with fds on %s", interface_name, signal_name, object_path);
+        g_object_unref(message);
+        return G_SOURCE_REMOVE;
+    }
+    sub->forwarded++;
+    
+    log_verbose("Signal received: %s.%s from %s with fds", interface_name, signal_name, sender);
+    SignalEmission *emission = signal_emission_new(object_path, interface_name, signal_name,
+                                                   g_dbus_message_get_body(message));
+    GUnixFDList *fd_list = g_dbus_message_get_unix_fd_list(message);
+    if (fd_list) emission->fd_list = (GUnixFDList *)g_object_ref(fd_list);
+    g_object_unref(message);
+    
+    dispatch_forwarded_signal(emission);
+    return G_SOURCE_REMOVE;
+}
+
+// Source bus filter for signals whose signature has fds. Signal subscriptions
+// only deliver the parsed body, which would leave the handles pointing at
+// nothing, so these are taken at the message level and checked on the main
+// loop by forward_fd_signal. Runs in the GDBus worker thread.
+static GDBusMessage *fd_signal_filter(GDBusConnection *connection G_GNUC_UNUSED,
+                                      GDBusMessage *message,
+                                      gboolean incoming,
+                                      gpointer user_data G_GNUC_UNUSED)
+{
+    if (incoming &&
+        g_dbus_message_get_message_type(message) == G_DBUS_MESSAGE_TYPE_SIGNAL &&
+        signature_has_fds(g_dbus_message_get_signature(message)) &&
+        g_dbus_message_get_body(message)) {
+        g_idle_add(forward_fd_signal, g_object_ref(message));
+    }
+    
+    return message;
+}
+
+// Initialize proxy state
+static gboolean init_proxy_state(const ProxyConfig *config)
+{
+    proxy_state = g_new0(ProxyState, 1);
+    proxy_state->config = *config;
+    proxy_state->objects = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                                 config->lazy_objects ? (GDestroyNotify)g_strfreev
+                                                                      : (GDestroyNotify)g_dbus_node_info_unref);
+    if (config->lazy_objects) {
+        proxy_state->object_children = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                                             g_free, (GDestroyNotify)g_ptr_array_unref);
+        proxy_state->object_info_cache = g_hash_table_new(g_str_hash, g_str_equal);
+        proxy_state->registered_subtrees = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    }
+    g_queue_init(&proxy_state->object_info_lru);
+    g_queue_init(&proxy_state->parked_calls);
+    proxy_state->caller_calls = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, caller_calls_free);
+    proxy_state->name_watches = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    proxy_state->admission.limit = config->max_in_flight;
+    proxy_state->admission.senders = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, sender_queue_free);
+    for (guint c = 0; c < PRIORITY_CLASSES; c++) g_queue_init(&proxy_state->admission.active[c]);
+    proxy_state->admission.weights = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    proxy_state->admission.priority_owners = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    proxy_state->breaker.since = g_get_monotonic_time();
+    proxy_state->breaker.window_start = proxy_state->breaker.since;
+    // Errors are named under the service raising them, here the proxy
+    proxy_state->breaker_error = g_strdup_printf("%s.Error.CircuitOpen", config->proxy_bus_name);
+    for (guint i = 0; i < config->priority_rules->len; i++) {
+        const PriorityRule *rule = (const PriorityRule *)g_ptr_array_index(config->priority_rules, i);
+        if (rule->match == PRIORITY_MATCH_SENDER && rule->name[0] != ':') proxy_state->priority_sender_names = TRUE;
+    }
+    if (config->introspection_cache_dir) {
+        proxy_state->introspection_hashes = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    }
+    proxy_state->interfaces = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                                    NULL, (GDestroyNotify)g_dbus_interface_info_unref);
+    proxy_state->registered_objects = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    proxy_state->signal_subscriptions = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                                              g_free, signal_subscription_free);
+    proxy_state->signal_match_ids = g_array_new(FALSE, FALSE, sizeof(guint));
+    signal_queue_init(&proxy_state->signal_queue);
+    if (g_hash_table_size(config->coalesce_windows) > 0) {
+        proxy_state->pending_properties = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                                                g_free, pending_properties_free);
+    }
+    if (config->property_cache) {
+        proxy_state->property_cache = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                                            g_free, property_cache_entry_free);
+    }
+    
+    return TRUE;
+}
+
+static void startup_fail(const char *what);
+static void source_lanes_ready();
+
+static void on_source_lane_ready(GObject *source G_GNUC_UNUSED, GAsyncResult *res, gpointer user_data)
+{
+    SourceLane *lane = (SourceLane *)user_data;
+    GError *error = NULL;
+    GDBusConnection *connection = g_dbus_connection_new_for_address_finish(res, &error);
+    
+    if (proxy_state->exit_status) {
+        if (connection) g_object_unref(connection);
+        if (error) g_error_free(error);
+        return;
+    }
+    
+    if (!connection) {
+        log_error("Failed to open private source connection: %s", error->message);
+        g_error_free(error);
+        startup_fail("source connections");
+        return;
+    }
+    
+    lane->connection = connection;
+    if (--proxy_state->lanes_pending == 0) source_lanes_ready();
+}
+
+// Start opening a private connection to the source bus. Unlike g_bus_get
+// this is not the process-wide shared connection, so it has its own socket.
+// The lane has no connection until on_source_lane_ready.
+static SourceLane *source_lane_new_private(const char *address)
+{
+    SourceLane *lane = g_new0(SourceLane, 1);
+    
+    proxy_state->lanes_pending++;
+    g_dbus_connection_new_for_address(
+        address,
+        (GDBusConnectionFlags)(G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+                               G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION),
+        NULL, // Auth observer
+        NULL, // Cancellable
+        on_source_lane_ready,
+        lane);
+    return lane;
+}
+
+static void source_lane_free(gpointer data)
+{
+    SourceLane *lane = (SourceLane *)data;
+    if (lane->connection) g_object_unref(lane->connection);
+    g_free(lane);
+}
+
+// Set up the lanes forwarded calls are spread over
+static gboolean connect_source_lanes()
+{
+    proxy_state->source_lanes = g_ptr_array_new_with_free_func(source_lane_free);
+    
+    guint pool_size = proxy_state->config.source_pool_size;
+    gboolean want_bulk = proxy_state->config.bulk_methods && proxy_state->config.bulk_methods->len > 0;
+    
+    if (pool_size == 0) {
+        SourceLane *lane = g_new0(SourceLane, 1);
+        lane->connection = (GDBusConnection *)g_object_ref(proxy_state->source_bus);
+        g_ptr_array_add(proxy_state->source_lanes, lane);
+        if (!want_bulk) return TRUE;
+    }
+    
+    GError *error = NULL;
+    gchar *address = g_dbus_address_get_for_bus_sync(proxy_state->config.source_bus_type, NULL, &error);
+    if (!address) {
+        log_error("Failed to resolve source bus address: %s", error->message);
+        g_error_free(error);
+        return FALSE;
+    }
+    
+    for (guint i = 0; i < pool_size; i++) {
+        g_ptr_array_add(proxy_state->source_lanes, source_lane_new_private(address));
+    }
+    
+    if (want_bulk) {
+        proxy_state->bulk_lane = source_lane_new_private(address);
+        proxy_state->bulk_methods = g_hash_table_new(g_str_hash, g_str_equal);
+        for (guint i = 0; i < proxy_state->config.bulk_methods->len; i++) {
+            g_hash_table_add(proxy_state->bulk_methods, g_ptr_array_index(proxy_state->config.bulk_methods, i));
+        }
+    }
+    
+    g_free(address);
+    return TRUE;
+}
+
+static gpointer shard_thread_main(gpointer data)
+{
+    ProxyShard *shard = (ProxyShard *)data;
+    
+    current_shard = shard;
+    g_main_context_push_thread_default(shard->context);
+    g_main_loop_run(shard->loop);
+    g_main_context_pop_thread_default(shard->context);
+    return NULL;
+}
+
+// Set up the worker shards, each with a private source connection. Their
+// threads start once the connections are up (source_lanes_ready). Replies to
+// calls a shard makes are dispatched to its own context, since it is the
+// thread-default context when the call is issued.
+static gboolean start_shards()
+{
+    guint n_shards = proxy_state->config.shards;
+    if (n_shards == 0) return TRUE;
+    
+    if (proxy_state->config.source_pool_size > 0 || proxy_state->bulk_lane) {
+        log_info("Source pool and bulk lane are not used with shards; each shard has its own connection");
+    }
+    
+    GError *error = NULL;
+    gchar *address = g_dbus_address_get_for_bus_sync(proxy_state->config.source_bus_type, NULL, &error);
+    if (!address) {
+        log_error("Failed to resolve source bus address: %s", error->message);
+        g_error_free(error);
+        return FALSE;
+    }
+    
+    proxy_state->shards = g_ptr_array_new();
+    for (guint i = 0; i < n_shards; i++) {
+        ProxyShard *shard = g_new0(ProxyShard, 1);
+        shard->index = i;
+        shard->lane = source_lane_new_private(address);
+        shard->context = g_main_context_new();
+        shard->loop = g_main_loop_new(shard->context, FALSE);
+        signal_queue_init(&shard->signal_queue);
+        g_ptr_array_add(proxy_state->shards, shard);
+    }
+    
+    g_free(address);
+    return TRUE;
+}
+
+static gboolean shard_quit(gpointer data)
+{
+    ProxyShard *shard = (ProxyShard *)data;
+    g_main_loop_quit(shard->loop);
+    return G_SOURCE_REMOVE;
+}
+
+// Stop the worker shards and wait for their threads. The quit is queued on
+// the shard's own context, so it cannot be lost on a thread whose loop has
+// not started running yet.
+static void stop_shards()
+{
+    if (!proxy_state->shards) return;
+    
+    for (guint i = 0; i < proxy_state->shards->len; i++) {
+        ProxyShard *shard = (ProxyShard *)g_ptr_array_index(proxy_state->shards, i);
+        if (shard->thread) {
+            shard_dispatch(shard, shard_quit, shard);
+            g_thread_join(shard->thread);
+        }
+        g_main_loop_unref(shard->loop);
+        g_main_context_unref(shard->context);
+        source_lane_free(shard->lane);
+        signal_queue_clear(&shard->signal_queue);
+        g_free(shard);
+    }
+    
+    g_ptr_array_free(proxy_state->shards, TRUE);
+    proxy_state->shards = NULL;
+}
+
+// Log how long a startup step took, and the time since startup began
+static void log_startup_phase(const char *what, gint64 phase_started)
+{
+    gint64 now = g_get_monotonic_time();
+    log_info("Startup: %s in %.1f ms (%.1f ms since start)", what,
+             (now - phase_started) / 1000.0, (now - proxy_state->startup_started) / 1000.0);
+}
+
+// Abort startup; main() returns once the loop has stopped
+static void startup_fail(const char *what)
+{
+    log_error("Startup failed: %s", what);
+    proxy_state->exit_status = 1;
+    g_main_loop_quit(proxy_state->main_loop);
+}
+
+static void fetch_introspection_data();
+static void startup_maybe_register();
+
+static void on_bus_ready(GObject *source G_GNUC_UNUSED, GAsyncResult *res, gpointer user_data)
+{
+    gboolean is_source = GPOINTER_TO_INT(user_data);
+    GError *error = NULL;
+    GDBusConnection *connection = g_bus_get_finish(res, &error);
+    
+    if (proxy_state->exit_status) {
+        if (connection) g_object_unref(connection);
+        if (error) g_error_free(error);
+        return;
+    }
+    
+    if (!connection) {
+        log_error("Failed to connect to %s bus: %s", is_source ? "source" : "target", error->message);
+        g_error_free(error);
+        startup_fail("bus connection");
+        return;
+    }
+    
+    if (is_source) {
+        proxy_state->source_bus = connection;
+        log_startup_phase(proxy_state->config.source_bus_type == G_BUS_TYPE_SYSTEM ? "connected to source bus (system)"
+                                                                                  : "connected to source bus (session)",
+                          proxy_state->startup_started);
+        
+        // Private connections open while discovery runs
+        proxy_state->lanes_started = g_get_monotonic_time();
+        if (!connect_source_lanes() || !start_shards()) {
+            startup_fail("source connections");
+            return;
+        }
+        if (proxy_state->lanes_pending == 0) source_lanes_ready();
+        
+        // Discovery only needs the source bus
+        fetch_introspection_data();
+    } else {
+        proxy_state->target_bus = connection;
+        log_startup_phase(proxy_state->config.target_bus_type == G_BUS_TYPE_SYSTEM ? "connected to target bus (system)"
+                                                                                  : "connected to target bus (session)",
+                          proxy_state->startup_started);
+        startup_maybe_register();
+    }
+}
+
+// Open both bus connections concurrently
+static void connect_to_buses()
+{
+    proxy_state->startup_phase = STARTUP_CONNECTING;
+    g_bus_get(proxy_state->config.source_bus_type, NULL, on_bus_ready, GINT_TO_POINTER(TRUE));
+    g_bus_get(proxy_state->config.target_bus_type, NULL, on_bus_ready, GINT_TO_POINTER(FALSE));
+}
+
+static void object_info_cache_entry_free(ObjectInfoCacheEntry *entry)
+{
+    g_free(entry->object_path);
+    g_dbus_node_info_unref(entry->node);
+    g_free(entry);
+}
+
+// Add or refresh an object's introspection data in the lazy mode's LRU,
+// evicting the least recently used objects beyond object_cache_size
+static void object_info_cache_insert(const char *object_path, GDBusNodeInfo *node)
+{
+    GList *link = (GList *)g_hash_table_lookup(proxy_state->object_info_cache, object_path);
+    if (link) {
+        ObjectInfoCacheEntry *entry = (ObjectInfoCacheEntry *)link->data;
+        g_dbus_node_info_unref(entry->node);
+        entry->node = g_dbus_node_info_ref(node);
+        g_queue_unlink(&proxy_state->object_info_lru, link);
+        g_queue_push_head_link(&proxy_state->object_info_lru, link);
+        return;
+    }
+    
+    ObjectInfoCacheEntry *entry = g_new0(ObjectInfoCacheEntry, 1);
+    entry->object_path = g_strdup(object_path);
+    entry->node = g_dbus_node_info_ref(node);
+    g_queue_push_head(&proxy_state->object_info_lru, entry);
+    g_hash_table_insert(proxy_state->object_info_cache, entry->object_path,
+                        g_queue_peek_head_link(&proxy_state->object_info_lru));
+    
+    while (g_queue_get_length(&proxy_state->object_info_lru) > MAX(proxy_state->config.object_cache_size, 1)) {
+        ObjectInfoCacheEntry *oldest = (ObjectInfoCacheEntry *)g_queue_pop_tail(&proxy_state->object_info_lru);
+        g_hash_table_remove(proxy_state->object_info_cache, oldest->object_path);
+        object_info_cache_entry_free(oldest);
+        shard_stats()->object_cache_evictions++;
+    }
+}
+
+// Introspection data for an object, built from interfaces already known by
+// name. GDBusNodeInfo is a plain refcounted struct, so this is released with
+// g_dbus_node_info_unref like a parsed one.
+static GDBusNodeInfo *object_node_new(const char *object_path, GPtrArray *interfaces)
+{
+    GDBusNodeInfo *node = g_new0(GDBusNodeInfo, 1);
+    node->ref_count = 1;
+    node->path = g_strdup(object_path);
+    node->interfaces = g_new0(GDBusInterfaceInfo *, interfaces->len + 1);
+    for (guint i = 0; i < interfaces->len; i++) {
+        node->interfaces[i] = g_dbus_interface_info_ref((GDBusInterfaceInfo *)g_ptr_array_index(interfaces, i));
+    }
+    return node;
+}
+
+// Introspection data of an object in lazy mode. A miss is rebuilt from the
+// interface names kept in objects and the mirrored interface table, so
+// GDBus' synchronous subtree callbacks never wait on the source.
+static GDBusNodeInfo *object_info_cache_lookup(const char *object_path)
+{
+    GList *link = (GList *)g_hash_table_lookup(proxy_state->object_info_cache, object_path);
+    if (link) {
+        g_queue_unlink(&proxy_state->object_info_lru, link);
+        g_queue_push_head_link(&proxy_state->object_info_lru, link);
+        shard_stats()->object_cache_hits++;
+        return ((ObjectInfoCacheEntry *)link->data)->node;
+    }
+    
+    const char *const *names = (const char *const *)g_hash_table_lookup(proxy_state->objects, object_path);
+    if (!names) return NULL;
+    
+    shard_stats()->object_cache_misses++;
+    log_verbose("Object cache miss, rebuilding %s", object_path);
+    
+    GPtrArray *infos = g_ptr_array_new();
+    for (int i = 0; names[i]; i++) {
+        GDBusInterfaceInfo *iface = lookup_interface_info(names[i]);
+        if (iface) g_ptr_array_add(infos, iface);
+    }
+    GDBusNodeInfo *node = object_node_new(object_path, infos);
+    g_ptr_array_unref(infos);
+    
+    object_info_cache_insert(object_path, node);
+    g_dbus_node_info_unref(node);
+    return ((ObjectInfoCacheEntry *)g_queue_peek_head(&proxy_state->object_info_lru))->node;
+}
+
+// Remember a child node name for subtree enumeration in lazy mode
+static void object_children_add(const char *parent, const char *name)
+{
+    GPtrArray *children = (GPtrArray *)g_hash_table_lookup(proxy_state->object_children, parent);
+    if (!children) {
+        children = g_ptr_array_new_with_free_func(g_free);
+        g_hash_table_insert(proxy_state->object_children, g_strdup(parent), children);
+    }
+    for (guint i = 0; i < children->len; i++) {
+        if (g_strcmp0((const char *)g_ptr_array_index(children, i), name) == 0) return;
+    }
+    g_ptr_array_add(children, g_strdup(name));
+}
+
+// Discovery of the object subtree under source_object_path. Children are
+// introspected as soon as their parent's reply names them, with up to
+// introspect_concurrency calls in flight, so a deep or wide tree costs
+// about (objects / concurrency) round trips rather than one per object.
+typedef struct IntrospectWalk IntrospectWalk;
+struct IntrospectWalk {
+    GQueue pending;       // IntrospectRequest not yet sent
+    guint in_flight;
+    guint calls;
+    guint failed;
+    gboolean root_failed;
+    gboolean collect_only;  // Only gather XML, leave the mirror alone (revalidation)
+    GHashTable *xml;        // Object path -> introspection XML, for the on-disk cache (may be NULL)
+    GHashTable *interfaces; // Collect-only: interface name -> info found, for done to swap in (may be NULL)
+    gint64 started;
+    void (*done)(IntrospectWalk *walk); // Called once the last reply is in
+    gpointer user_data;
+};
+
+// One object waiting to be introspected
+typedef struct {
+    IntrospectWalk *walk;
+    gchar *object_path;
+    guint depth;          // Levels below source_object_path
+} IntrospectRequest;
+
+static void introspect_walk_launch(IntrospectWalk *walk);
+
+// Path of a child node named in an introspection reply
+static gchar *child_object_path(const char *parent, const char *name)
+{
+    if (name[0] == '/') return g_strdup(name);
+    return g_strcmp0(parent, "/") == 0 ? g_strconcat("/", name, NULL) : g_strconcat(parent, "/", name, NULL);
+}
+
+// Add an introspected object to the mirror. replace_interfaces makes its
+// interface info win over what is known by name (revalidated data).
+static void mirror_introspected_node(const char *object_path, GDBusNodeInfo *node, gboolean replace_interfaces)
+{
+    for (int i = 0; node->interfaces && node->interfaces[i]; i++) {
+        GDBusInterfaceInfo *iface = node->interfaces[i];
+        if (replace_interfaces || !g_hash_table_contains(proxy_state->interfaces, iface->name)) {
+            mirrored_interfaces_set(iface->name, iface);
+        }
+    }
+    
+    gboolean lazy = proxy_state->config.lazy_objects;
+    
+    // The lazy mode only keeps the shape of the tree; introspection data
+    // goes to the bounded LRU and is rebuilt from the interface names once evicted
+    if (node->interfaces && node->interfaces[0]) {
+        mirrored_objects_set(object_path, node, FALSE);
+    }
+    if (lazy) object_info_cache_insert(object_path, node);
+    
+    // Objects below an ObjectManager come from one GetManagedObjects instead
+    if (g_strcmp0(object_path, proxy_state->config.source_object_path) == 0 &&
+        proxy_state->config.object_manager && !proxy_state->object_manager_path &&
+        g_dbus_node_info_lookup_interface(node, "org.freedesktop.DBus.ObjectManager")) {
+        proxy_state->object_manager_path = g_strdup(object_path);
+    }
+}
+
+// Record an introspected object and queue its children
+static void introspect_walk_add_node(IntrospectWalk *walk, IntrospectRequest *request, GDBusNodeInfo *node)
+{
+    gboolean lazy = proxy_state->config.lazy_objects && !walk->collect_only;
+    
+    if (!walk->collect_only) mirror_introspected_node(request->object_path, node, FALSE);
+    for (int i = 0; walk->interfaces && node->interfaces && node->interfaces[i]; i++) {
+        GDBusInterfaceInfo *iface = node->interfaces[i];
+        g_hash_table_replace(walk->interfaces, iface->name, g_dbus_interface_info_ref(iface));
+    }
+    
+    if (g_strcmp0(request->object_path, proxy_state->object_manager_path) == 0) return;
+    if (request->depth >= proxy_state->config.introspect_depth) return;
+    
+    for (int i = 0; node->nodes && node->nodes[i]; i++) {
+        if (!node->nodes[i]->path) continue;
+        if (lazy) object_children_add(request->object_path, node->nodes[i]->path);
+        IntrospectRequest *child = g_new0(IntrospectRequest, 1);
+        child->walk = walk;
+        child->object_path = child_object_path(request->object_path, node->nodes[i]->path);
+        child->depth = request->depth + 1;
+        g_queue_push_tail(&walk->pending, child);
+    }
+}
+
+static void on_introspect_reply(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    IntrospectRequest *request = (IntrospectRequest *)user_data;
+    IntrospectWalk *walk = request->walk;
+    GError *error = NULL;
+    GDBusNodeInfo *node = NULL;
+    
+    walk->in_flight--;
+    
+    GVariant *xml_variant = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, &error);
+    if (xml_variant) {
+        const char *xml_data;
+        g_variant_get(xml_variant, "(&s)", &xml_data);
+        log_verbose("Introspection XML received for %s (%zu bytes)", request->object_path, strlen(xml_data));
+        node = g_dbus_node_info_new_for_xml(xml_data, &error);
+    }
+    
+    if (node) {
+        if (walk->xml) {
+            const char *xml_data;
+            g_variant_get(xml_variant, "(&s)", &xml_data);
+            g_hash_table_replace(walk->xml, g_strdup(request->object_path), g_strdup(xml_data));
+        }
+        introspect_walk_add_node(walk, request, node);
+        g_dbus_node_info_unref(node);
+    } else {
+        // Objects can vanish while we walk; only the root is required
+        log_error("Introspection of %s failed: %s", request->object_path, error->message);
+        g_error_free(error);
+        walk->failed++;
+        if (request->depth == 0) walk->root_failed = TRUE;
+    }
+    
+    if (xml_variant) g_variant_unref(xml_variant);
+    g_free(request->object_path);
+    g_free(request);
+    introspect_walk_launch(walk);
+    
+    if (walk->done && walk->in_flight == 0) walk->done(walk);
+}
+
+// Send queued Introspect calls up to the concurrency limit
+static void introspect_walk_launch(IntrospectWalk *walk)
+{
+    while (walk->in_flight < MAX(proxy_state->config.introspect_concurrency, 1) &&
+           !g_queue_is_empty(&walk->pending)) {
+        IntrospectRequest *request = (IntrospectRequest *)g_queue_pop_head(&walk->pending);
+        walk->in_flight++;
+        walk->calls++;
+        
+        g_dbus_connection_call(
+            proxy_state->source_bus,
+            proxy_state->config.source_bus_name,
+            request->object_path,
+            "org.freedesktop.DBus.Introspectable",
+            "Introspect",
+            NULL,
+            G_VARIANT_TYPE("(s)"),
+            G_DBUS_CALL_FLAGS_NONE,
+            -1,
+            NULL,
+            on_introspect_reply,
+            request);
+    }
+}
+
+// Current introspection data of a mirrored object, NULL if it is not mirrored
+static GDBusNodeInfo *mirrored_object_info(const char *object_path)
+{
+    if (!g_hash_table_contains(proxy_state->objects, object_path)) return NULL;
+    
+    return proxy_state->config.lazy_objects ? object_info_cache_lookup(object_path)
+                                            : (GDBusNodeInfo *)g_hash_table_lookup(proxy_state->objects, object_path);
+}
+
+// Fill the property cache of one interface from an a{sv} snapshot, so the
+// registration does not seed it with a GetAll of its own
+static void property_cache_preload(const char *object_path, GDBusInterfaceInfo *iface, GVariant *properties)
+{
+    property_cache_add_interface(object_path, iface);
+    
+    PropertyCacheEntry *entry = property_cache_lookup_entry(object_path, iface->name);
+    if (entry) property_cache_store_all(entry, iface->name, properties);
+}
+
+// Mirror the objects of one GetManagedObjects reply (a{oa{sa{sv}}})
+static void mirror_managed_objects(GVariant *objects)
+{
+    GVariantIter object_iter;
+    const char *object_path;
+    GVariant *interfaces;
+    
+    g_variant_iter_init(&object_iter, objects);
+    while (g_variant_iter_next(&object_iter, "{&o@a{sa{sv}}}", &object_path, &interfaces)) {
+        GDBusNodeInfo *existing = mirrored_object_info(object_path);
+        GPtrArray *infos = g_ptr_array_new();
+        GVariantIter iface_iter;
+        const char *interface_name;
+        GVariant *properties;
+        
+        for (int i = 0; existing && existing->interfaces && existing->interfaces[i]; i++) {
+            g_ptr_array_add(infos, existing->interfaces[i]);
+        }
+        
+        g_variant_iter_init(&iface_iter, interfaces);
+        while (g_variant_iter_next(&iface_iter, "{&s@a{sv}}", &interface_name, &properties)) {
+            GDBusInterfaceInfo *iface = lookup_interface_info(interface_name);
+            if (!iface) {
+                log_error("No introspection data for %s on %s, not mirrored", interface_name, object_path);
+            } else {
+                if (!existing || !g_dbus_node_info_lookup_interface(existing, interface_name)) {
+                    g_ptr_array_add(infos, iface);
+                }
+                property_cache_preload(object_path, iface, properties);
+            }
+            g_variant_unref(properties);
+        }
+        
+        GDBusNodeInfo *node = object_node_new(object_path, infos);
+        mirrored_objects_set(object_path, node, FALSE);
+        if (proxy_state->config.lazy_objects) {
+            object_info_cache_insert(object_path, node);
+            gchar *parent = g_path_get_dirname(object_path);
+            gchar *name = g_path_get_basename(object_path);
+            object_children_add(parent, name);
+            g_free(parent);
+            g_free(name);
+        }
+        g_dbus_node_info_unref(node);
+        g_ptr_array_unref(infos);
+        g_variant_unref(interfaces);
+    }
+}
+
+static void introspection_done(gboolean ok);
+
+static void on_managed_objects_introspected(IntrospectWalk *walk)
+{
+    GVariant *objects = (GVariant *)walk->user_data;
+    
+    mirror_managed_objects(objects);
+    log_info("ObjectManager provided %" G_GSIZE_FORMAT " object(s) (%u Introspect calls for interface data)",
+             g_variant_n_children(objects), walk->calls);
+    
+    g_variant_unref(objects);
+    g_free(walk);
+    introspection_done(TRUE);
+}
+
+// Introspect one object per interface of a GetManagedObjects reply we have
+// no data for yet, then hand the reply (walk->user_data) to done. With
+// refresh, every interface is introspected again into walk->interfaces and
+// the mirror is left alone, so done decides what to swap in.
+static void managed_objects_introspect(GVariant *objects, gboolean refresh, void (*done)(IntrospectWalk *walk))
+{
+    IntrospectWalk *walk = g_new0(IntrospectWalk, 1);
+    GHashTable *wanted = g_hash_table_new(g_str_hash, g_str_equal);
+    GVariantIter object_iter;
+    const char *object_path;
+    GVariant *interfaces;
+    
+    g_queue_init(&walk->pending);
+    walk->done = done;
+    walk->user_data = objects;
+    if (refresh) {
+        walk->collect_only = TRUE;
+        walk->interfaces = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+                                                 (GDestroyNotify)g_dbus_interface_info_unref);
+    }
+    
+    g_variant_iter_init(&object_iter, objects);
+    while (g_variant_iter_next(&object_iter, "{&o@a{sa{sv}}}", &object_path, &interfaces)) {
+        GVariantIter iface_iter;
+        const char *interface_name;
+        gboolean queued = FALSE;
+        
+        g_variant_iter_init(&iface_iter, interfaces);
+        while (g_variant_iter_next(&iface_iter, "{&s@a{sv}}", &interface_name, NULL)) {
+            if ((!refresh && lookup_interface_info(interface_name)) || g_hash_table_contains(wanted, interface_name)) {
+                continue;
+            }
+            g_hash_table_add(wanted, (gpointer)interface_name);
+            if (queued) continue;
+            
+            IntrospectRequest *request = g_new0(IntrospectRequest, 1);
+            request->walk = walk;
+            request->object_path = g_strdup(object_path);
+            request->depth = G_MAXUINT; // Interface data only, no children
+            g_queue_push_tail(&walk->pending, request);
+            queued = TRUE;
+        }
+        g_variant_unref(interfaces);
+    }
+    g_hash_table_destroy(wanted);
+    
+    introspect_walk_launch(walk);
+    if (walk->in_flight == 0) done(walk);
+}
+
+static void on_managed_objects_reply(GObject *source, GAsyncResult *res, gpointer user_data G_GNUC_UNUSED)
+{
+    GError *error = NULL;
+    GVariant *reply = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, &error);
+    
+    if (!reply) {
+        log_error("GetManagedObjects failed: %s", error->message);
+        g_error_free(error);
+        introspection_done(FALSE);
+        return;
+    }
+    
+    GVariant *objects = g_variant_get_child_value(reply, 0);
+    g_variant_unref(reply);
+    managed_objects_introspect(objects, FALSE, on_managed_objects_introspected);
+}
+
+// Bulk-load the subtree from the source's ObjectManager: one GetManagedObjects
+// for every object, interface and property value, plus one Introspect per
+// interface not seen yet (interface info is shared by name)
+static void load_managed_objects()
+{
+    log_info("Loading objects from ObjectManager at %s", proxy_state->object_manager_path);
+    
+    g_dbus_connection_call(
+        proxy_state->source_bus,
+        proxy_state->config.source_bus_name,
+        proxy_state->object_manager_path,
+        "org.freedesktop.DBus.ObjectManager",
+        "GetManagedObjects",
+        NULL,
+        G_VARIANT_TYPE("(a{oa{sa{sv}}})"),
+        G_DBUS_CALL_FLAGS_NONE,
+        -1,
+        NULL,
+        on_managed_objects_reply,
+        NULL);
+}
+
+// Cache file for this source name and object path
+static gchar *introspection_cache_file()
+{
+    gchar *key = g_strconcat(proxy_state->config.source_bus_name, " ", proxy_state->config.source_object_path, NULL);
+    gchar *digest = g_compute_checksum_for_string(G_CHECKSUM_SHA256, key, -1);
+    gchar *file = g_strconcat(proxy_state->config.introspection_cache_dir, "/", digest, ".introspection", NULL);
+    
+    g_free(digest);
+    g_free(key);
+    return file;
+}
+
+// Cache file layout: a serialized GVariant (version, {path: (sha256, xml)}),
+// memory-mapped on load so nothing is copied before it is parsed
+#define INTROSPECTION_CACHE_VERSION 1
+#define INTROSPECTION_CACHE_TYPE "(ua{s(ss)})"
+
+// Write the XML gathered by a walk to the cache and remember its hashes
+static void introspection_cache_store(GHashTable *xml)
+{
+    GVariantBuilder entries;
+    GHashTableIter iter;
+    gpointer key, value;
+    GError *error = NULL;
+    
+    g_hash_table_remove_all(proxy_state->introspection_hashes);
+    g_variant_builder_init(&entries, G_VARIANT_TYPE("a{s(ss)}"));
+    g_hash_table_iter_init(&iter, xml);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        gchar *digest = g_compute_checksum_for_string(G_CHECKSUM_SHA256, (const char *)value, -1);
+        g_variant_builder_add(&entries, "{s(ss)}", (const char *)key, digest, (const char *)value);
+        g_hash_table_insert(proxy_state->introspection_hashes, g_strdup((const char *)key), digest);
+    }
+    
+    GVariant *cache = g_variant_ref_sink(g_variant_new("(u@a{s(ss)})", INTROSPECTION_CACHE_VERSION,
+                                                       g_variant_builder_end(&entries)));
+    gchar *file = introspection_cache_file();
+    
+    if (g_mkdir_with_parents(proxy_state->config.introspection_cache_dir, 0700) != 0 ||
+        !g_file_set_contents(file, (const gchar *)g_variant_get_data(cache), g_variant_get_size(cache), &error)) {
+        log_error("Failed to write introspection cache %s: %s", file, error ? error->message : "cannot create directory");
+        if (error) g_error_free(error);
+    } else {
+        log_verbose("Introspection cache written: %s (%u objects)", file, g_hash_table_size(xml));
+    }
+    
+    g_free(file);
+    g_variant_unref(cache);
+}
+
+// Mirror the objects recorded in the cache. Returns FALSE if there is no
+// usable cache, in which case the tree is walked as usual.
+static gboolean introspection_cache_load()
+{
+    gint64 started = g_get_monotonic_time();
+    gchar *file = introspection_cache_file();
+    GError *error = NULL;
+    
+    GMappedFile *mapped = g_mapped_file_new(file, FALSE, &error);
+    if (!mapped) {
+        log_verbose("No introspection cache at %s: %s", file, error->message);
+        g_error_free(error);
+        g_free(file);
+        return FALSE;
+    }
+    
+    GBytes *bytes = g_mapped_file_get_bytes(mapped);
+    GVariant *cache = g_variant_ref_sink(g_variant_new_from_bytes(G_VARIANT_TYPE(INTROSPECTION_CACHE_TYPE),
+                                                                  bytes, FALSE));
+    g_bytes_unref(bytes);
+    g_mapped_file_unref(mapped);
+    
+    guint32 version;
+    GVariant *entries;
+    g_variant_get(cache, "(u@a{s(ss)})", &version, &entries);
+    
+    gboolean loaded = version == INTROSPECTION_CACHE_VERSION;
+    GVariantIter iter;
+    const char *object_path, *digest, *xml_data;
+    
+    g_variant_iter_init(&iter, entries);
+    while (loaded && g_variant_iter_next(&iter, "{&s(&s&s)}", &object_path, &digest, &xml_data)) {
+        GDBusNodeInfo *node = g_dbus_node_info_new_for_xml(xml_data, NULL);
+        if (!node) {
+            log_error("Introspection cache %s is corrupt, ignoring it", file);
+            loaded = FALSE;
+            break;
+        }
+        
+        mirror_introspected_node(object_path, node, FALSE);
+        if (proxy_state->config.lazy_objects && g_strcmp0(object_path, proxy_state->config.source_object_path) != 0) {
+            gchar *parent = g_path_get_dirname(object_path);
+            gchar *name = g_path_get_basename(object_path);
+            object_children_add(parent, name);
+            g_free(parent);
+            g_free(name);
+        }
+        g_hash_table_insert(proxy_state->introspection_hashes, g_strdup(object_path), g_strdup(digest));
+        g_dbus_node_info_unref(node);
+    }
+    
+    if (loaded && g_hash_table_size(proxy_state->objects) > 0) {
+        log_info("Loaded %u object(s) from introspection cache in %.1f ms",
+                 g_hash_table_size(proxy_state->objects), (g_get_monotonic_time() - started) / 1000.0);
+    } else {
+        // Start over from an empty mirror and walk the tree
+        g_hash_table_remove_all(proxy_state->introspection_hashes);
+        G_LOCK(mirrored_objects);
+        g_hash_table_remove_all(proxy_state->objects);
+        G_UNLOCK(mirrored_objects);
+        G_LOCK(mirrored_interfaces);
+        g_hash_table_remove_all(proxy_state->interfaces);
+        G_UNLOCK(mirrored_interfaces);
+        g_clear_pointer(&proxy_state->object_manager_path, g_free);
+        if (proxy_state->object_children) g_hash_table_remove_all(proxy_state->object_children);
+        loaded = FALSE;
+    }
+    
+    g_variant_unref(entries);
+    g_variant_unref(cache);
+    g_free(file);
+    return loaded;
+}
+
+static void on_startup_walk_done(IntrospectWalk *walk)
+{
+    gboolean ok = !walk->root_failed;
+    
+    if (walk->xml) {
+        if (ok) introspection_cache_store(walk->xml);
+        g_hash_table_destroy(walk->xml);
+    }
+    if (ok) {
+        log_info("Introspected %u object(s) with %u interface(s) in %.1f ms (%u calls, %u failed)",
+                 g_hash_table_size(proxy_state->objects), g_hash_table_size(proxy_state->interfaces),
+                 (g_get_monotonic_time() - walk->started) / 1000.0, walk->calls, walk->failed);
+    }
+    g_free(walk);
+    
+    if (ok && proxy_state->object_manager_path) {
+        load_managed_objects();
+    } else {
+        introspection_done(ok);
+    }
+}
+
+// Mirror the objects of the compiled-in profile. Its info structures are
+// static, so nothing is parsed and registration uses them as they are.
+static void profile_load(const ProxyProfile *profile)
+{
+    gint64 started = g_get_monotonic_time();
+    
+    proxy_state->profile_method_calls = g_new0(gsize, profile->n_methods);
+    proxy_state->profile_method_names = g_ptr_array_new_full(profile->n_methods, g_free);
+    g_ptr_array_set_size(proxy_state->profile_method_names, profile->n_methods);
+    
+    for (guint i = 0; i < profile->n_objects; i++) {
+        const ProxyProfileObject *object = &profile->objects[i];
+        GPtrArray *interfaces = g_ptr_array_new();
+        
+        for (int j = 0; object->interfaces[j]; j++) {
+            GDBusInterfaceInfo *iface = object->interfaces[j];
+            g_ptr_array_add(interfaces, iface);
+            for (int k = 0; iface->methods && iface->methods[k]; k++) {
+                const ProxyProfileMethodInfo *method = proxy_profile_method(iface->methods[k]);
+                // Interfaces shared by several objects list the same methods
+                if (!g_ptr_array_index(proxy_state->profile_method_names, method->id)) {
+                    g_ptr_array_index(proxy_state->profile_method_names, method->id) =
+                        g_strconcat(iface->name, ".", method->parent.name, NULL);
+                }
+            }
+        }
+        
+        GDBusNodeInfo *node = object_node_new(object->object_path, interfaces);
+        mirror_introspected_node(object->object_path, node, FALSE);
+        // Profiles only list objects with interfaces; link up their ancestors too
+        gchar *path = g_strdup(object->object_path);
+        while (proxy_state->config.lazy_objects && g_str_has_prefix(path, profile->source_object_path) &&
+               g_strcmp0(path, profile->source_object_path) != 0) {
+            gchar *parent = g_path_get_dirname(path);
+            gchar *name = g_path_get_basename(path);
+            object_children_add(parent, name);
+            g_free(name);
+            g_free(path);
+            path = parent;
+        }
+        g_free(path);
+        g_dbus_node_info_unref(node);
+        g_ptr_array_unref(interfaces);
+    }
+    
+    log_info("Loaded %u object(s) from profile %s in %.1f ms",
+             profile->n_objects, profile->name, (g_get_monotonic_time() - started) / 1000.0);
+}
+
+static void on_source_appeared(GDBusConnection *connection, const gchar *name, const gchar *name_owner,
+                               gpointer user_data);
+static void on_source_vanished(GDBusConnection *connection, const gchar *name, gpointer user_data);
+
+// Discover the source object and its subtree, from the compiled-in profile
+// or the on-disk cache if there is one. Finishes in introspection_done().
+static void fetch_introspection_data()
+{
+    proxy_state->startup_phase = STARTUP_INTROSPECTING;
+    
+    // Track the owner from here on, so a restart during startup is noticed
+    proxy_state->source_watch_id = g_bus_watch_name_on_connection(proxy_state->source_bus,
+                                                                  proxy_state->config.source_bus_name,
+                                                                  G_BUS_NAME_WATCHER_FLAGS_NONE,
+                                                                  on_source_appeared,
+                                                                  on_source_vanished,
+                                                                  NULL,
+                                                                  NULL);
+    
+    if (proxy_state->config.profile) {
+        profile_load(proxy_state->config.profile);
+        if (proxy_state->object_manager_path) {
+            load_managed_objects();
+        } else {
+            introspection_done(TRUE);
+        }
+        return;
+    }
+    
+    if (proxy_state->introspection_hashes && introspection_cache_load()) {
+        proxy_state->started_from_cache = TRUE;
+        if (proxy_state->object_manager_path) {
+            load_managed_objects();
+        } else {
+            introspection_done(TRUE);
+        }
+        return;
+    }
+    
+    gchar *depth = proxy_state->config.introspect_depth == G_MAXUINT
+        ? g_strdup("all") : g_strdup_printf("%u", proxy_state->config.introspect_depth);
+    log_info("Fetching introspection data from %s%s (depth %s, %u in flight)", 
+             proxy_state->config.source_bus_name, 
+             proxy_state->config.source_object_path,
+             depth,
+             proxy_state->config.introspect_concurrency);
+    g_free(depth);
+    
+    IntrospectWalk *walk = g_new0(IntrospectWalk, 1);
+    g_queue_init(&walk->pending);
+    walk->started = g_get_monotonic_time();
+    walk->done = on_startup_walk_done;
+    if (proxy_state->introspection_hashes) {
+        walk->xml = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    }
+    
+    IntrospectRequest *root = g_new0(IntrospectRequest, 1);
+    root->walk = walk;
+    root->object_path = g_strdup(proxy_state->config.source_object_path);
+    g_queue_push_tail(&walk->pending, root);
+    introspect_walk_launch(walk);
+}
+
+static const GDBusInterfaceVTable proxy_vtable = {
+    .method_call = handle_method_call,
+    .get_property = NULL, // Properties are forwarded asynchronously via method_call
+    .set_property = NULL,
+    .padding = {0} // Initialize padding array
+};
+
+// Register one interface of a source object on the target bus and index its
+// signals. Returns the number of signals it declares, -1 on failure.
+static gint register_proxy_interface(const char *object_path, GDBusInterfaceInfo *iface)
+{
+    GError *error = NULL;
+    gint signals = 0;
+    
+    log_verbose("Registering interface: %s on %s", iface->name, object_path);
+    
+    guint registration_id = g_dbus_connection_register_object(
+        proxy_state->target_bus,
+        object_path,
+        iface,
+        &proxy_vtable,
+        NULL, // user_data
+        NULL, // user_data_free_func
+        &error);
+    
+    if (registration_id == 0) {
+        log_error("Failed to register interface %s on %s: %s", iface->name, object_path, error->message);
+        g_error_free(error);
+        return -1;
+    }
+    
+    g_hash_table_insert(proxy_state->registered_objects,
+                        g_strconcat(object_path, " ", iface->name, NULL),
+                        GUINT_TO_POINTER(registration_id));
+    
+    // Interfaces loaded from GetManagedObjects arrive with their values
+    if (!property_cache_lookup_entry(object_path, iface->name)) {
+        property_cache_add_interface(object_path, iface);
+        property_cache_seed(object_path, iface);
+    }
+    
+    for (int j = 0; iface->signals && iface->signals[j]; j++) {
+        signal_subscription_add(object_path, iface->name, iface->signals[j]->name);
+        signals++;
+    }
+    return signals;
+}
+
+// Remove one interface of a mirrored object from the target bus, the
+// property cache and the signal index
+static void unregister_proxy_interface(const char *object_path, const char *interface_name)
+{
+    gchar *key = g_strconcat(object_path, " ", interface_name, NULL);
+    gpointer registration_id;
+    
+    if (g_hash_table_lookup_extended(proxy_state->registered_objects, key, NULL, &registration_id)) {
+        g_dbus_connection_unregister_object(proxy_state->target_bus, GPOINTER_TO_UINT(registration_id));
+        g_hash_table_remove(proxy_state->registered_objects, key);
+    }
+    if (proxy_state->property_cache) {
+        g_hash_table_remove(proxy_state->property_cache, key);
+    }
+    
+    // Signal index keys are "path interface member"
+    gchar *prefix = g_strconcat(key, " ", NULL);
+    GHashTableIter iter;
+    gpointer index_key;
+    g_hash_table_iter_init(&iter, proxy_state->signal_subscriptions);
+    while (g_hash_table_iter_next(&iter, &index_key, NULL)) {
+        if (g_str_has_prefix((const char *)index_key, prefix)) g_hash_table_iter_remove(&iter);
+    }
+    
+    g_free(prefix);
+    g_free(key);
+}
+
+// Register the interfaces of one source object on the target bus and index
+// its signals. Returns the number of signals it declares.
+static gint register_proxy_object(const char *object_path, GDBusNodeInfo *node)
+{
+    gint signals = 0;
+    
+    for (int i = 0; node->interfaces && node->interfaces[i]; i++) {
+        gint iface_signals = register_proxy_interface(object_path, node->interfaces[i]);
+        if (iface_signals < 0) return -1;
+        signals += iface_signals;
+    }
+    
+    // PropertiesChanged feeds the property cache even when the introspection
+    // data does not list org.freedesktop.DBus.Properties
+    signal_subscription_add(object_path, "org.freedesktop.DBus.Properties", "PropertiesChanged");
+    return signals + 1;
+}
+
+// Full path of a node in a subtree registered at object_path
+static gchar *subtree_node_path(const char *object_path, const char *node)
+{
+    return node ? child_object_path(object_path, node) : g_strdup(object_path);
+}
+
+static gchar **on_subtree_enumerate(GDBusConnection *connection G_GNUC_UNUSED,
+                                    const gchar *sender G_GNUC_UNUSED,
+                                    const gchar *object_path,
+                                    gpointer user_data G_GNUC_UNUSED)
+{
+    GPtrArray *children = (GPtrArray *)g_hash_table_lookup(proxy_state->object_children, object_path);
+    GPtrArray *names = g_ptr_array_new();
+    
+    for (guint i = 0; children && i < children->len; i++) {
+        g_ptr_array_add(names, g_strdup((const char *)g_ptr_array_index(children, i)));
+    }
+    g_ptr_array_add(names, NULL);
+    return (gchar **)g_ptr_array_free(names, FALSE);
+}
+
+static GDBusInterfaceInfo **on_subtree_introspect(GDBusConnection *connection G_GNUC_UNUSED,
+                                                  const gchar *sender G_GNUC_UNUSED,
+                                                  const gchar *object_path,
+                                                  const gchar *node,
+                                                  gpointer user_data G_GNUC_UNUSED)
+{
+    gchar *path = subtree_node_path(object_path, node);
+    GDBusNodeInfo *info = g_hash_table_contains(proxy_state->objects, path) ? object_info_cache_lookup(path) : NULL;
+    g_free(path);
+    
+    if (!info || !info->interfaces) return NULL;
+    
+    // GDBus supplies the standard org.freedesktop.DBus.* interfaces itself
+    GPtrArray *interfaces = g_ptr_array_new();
+    for (int i = 0; info->interfaces[i]; i++) {
+        if (g_str_has_prefix(info->interfaces[i]->name, "org.freedesktop.DBus.")) continue;
+        g_ptr_array_add(interfaces, g_dbus_interface_info_ref(info->interfaces[i]));
+    }
+    g_ptr_array_add(interfaces, NULL);
+    return (GDBusInterfaceInfo **)g_ptr_array_free(interfaces, FALSE);
+}
+
+static const GDBusInterfaceVTable *on_subtree_dispatch(GDBusConnection *connection G_GNUC_UNUSED,
+                                                       const gchar *sender G_GNUC_UNUSED,
+                                                       const gchar *object_path G_GNUC_UNUSED,
+                                                       const gchar *interface_name G_GNUC_UNUSED,
+                                                       const gchar *node G_GNUC_UNUSED,
+                                                       gpointer *out_user_data,
+                                                       gpointer user_data G_GNUC_UNUSED)
+{
+    *out_user_data = NULL;
+    return &proxy_vtable;
+}
+
+static const GDBusSubtreeVTable proxy_subtree_vtable = {
+    .enumerate = on_subtree_enumerate,
+    .introspect = on_subtree_introspect,
+    .dispatch = on_subtree_dispatch,
+    .padding = {0}
+};
+
+// Serve the children of one parent path through a subtree registration
+static gboolean register_proxy_subtree(const char *object_path)
+{
+    GError *error = NULL;
+    
+    if (g_hash_table_contains(proxy_state->registered_subtrees, object_path)) return TRUE;
+    
+    guint registration_id = g_dbus_connection_register_subtree(
+        proxy_state->target_bus,
+        object_path,
+        &proxy_subtree_vtable,
+        G_DBUS_SUBTREE_FLAGS_NONE,
+        NULL, // user_data
+        NULL, // user_data_free_func
+        &error);
+    
+    if (registration_id == 0) {
+        log_error("Failed to register subtree %s: %s", object_path, error->message);
+        g_error_free(error);
+        return FALSE;
+    }
+    g_hash_table_insert(proxy_state->registered_subtrees, g_strdup(object_path), GUINT_TO_POINTER(registration_id));
+    return TRUE;
+}
+
+// Lazy mode: one subtree registration per object that has children instead
+// of one registration per interface per object. GDBus subtrees are flat, so
+// every parent path needs its own. Interface info is looked up on first
+// access through the object cache.
+static gboolean register_proxy_subtrees()
+{
+    GPtrArray *parents = g_ptr_array_new();
+    GHashTableIter iter;
+    gpointer key;
+    
+    g_hash_table_iter_init(&iter, proxy_state->object_children);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        g_ptr_array_add(parents, key);
+    }
+    if (!g_hash_table_contains(proxy_state->object_children, proxy_state->config.source_object_path)) {
+        g_ptr_array_add(parents, (gpointer)proxy_state->config.source_object_path);
+    }
+    
+    for (guint i = 0; i < parents->len; i++) {
+        if (!register_proxy_subtree((const char *)g_ptr_array_index(parents, i))) {
+            g_ptr_array_unref(parents);
+            return FALSE;
+        }
+    }
+    
+    log_info("Registered %u subtree(s) serving %u object(s) lazily",
+             parents->len, g_hash_table_size(proxy_state->objects));
+    g_ptr_array_unref(parents);
+    return TRUE;
+}
+
+// Bring the target side up to date after mirror_managed_objects changed or
+// added an object: register interfaces that are new (eager mode) or make
+// sure its parent subtree is served (lazy mode)
+static void mirror_object_refresh(const char *object_path)
+{
+    if (proxy_state->config.lazy_objects) {
+        gchar *parent = g_path_get_dirname(object_path);
+        register_proxy_subtree(parent);
+        g_free(parent);
+        return;
+    }
+    
+    GDBusNodeInfo *node = (GDBusNodeInfo *)g_hash_table_lookup(proxy_state->objects, object_path);
+    gboolean new_object = TRUE;
+    
+    for (int i = 0; node && node->interfaces && node->interfaces[i]; i++) {
+        gchar *key = g_strconcat(object_path, " ", node->interfaces[i]->name, NULL);
+        if (g_hash_table_contains(proxy_state->registered_objects, key)) {
+            new_object = FALSE;
+        } else {
+            register_proxy_interface(object_path, node->interfaces[i]);
+            shard_stats()->interfaces_added++;
+        }
+        g_free(key);
+    }
+    if (new_object) {
+        signal_subscription_add(object_path, "org.freedesktop.DBus.Properties", "PropertiesChanged");
+    }
+}
+
+// Mirror an InterfacesAdded (oa{sa{sv}}) payload whose interfaces are known
+static void mirror_interfaces_added(GVariant *parameters)
+{
+    const char *object_path;
+    GVariant *interfaces;
+    GVariantBuilder builder;
+    
+    g_variant_get(parameters, "(&o@a{sa{sv}})", &object_path, &interfaces);
+    
+    g_variant_builder_init(&builder, G_VARIANT_TYPE("a{oa{sa{sv}}}"));
+    g_variant_builder_add(&builder, "{o@a{sa{sv}}}", object_path, interfaces);
+    GVariant *objects = g_variant_ref_sink(g_variant_builder_end(&builder));
+    
+    mirror_managed_objects(objects);
+    mirror_object_refresh(object_path);
+    
+    g_variant_unref(objects);
+    g_variant_unref(interfaces);
+}
+
+static void object_manager_release();
+
+// InterfacesAdded from the source's ObjectManager. Interfaces we have no
+// introspection data for are introspected first; returns TRUE if so, and
+// the signal is then forwarded once the object is registered.
+static gboolean on_interfaces_added(GVariant *parameters)
+{
+    const char *object_path;
+    GVariant *interfaces;
+    GVariantIter iter;
+    const char *interface_name;
+    gboolean known = TRUE;
+    
+    g_variant_get(parameters, "(&o@a{sa{sv}})", &object_path, &interfaces);
+    g_variant_iter_init(&iter, interfaces);
+    while (g_variant_iter_next(&iter, "{&s@a{sv}}", &interface_name, NULL)) {
+        if (!lookup_interface_info(interface_name)) known = FALSE;
+    }
+    g_variant_unref(interfaces);
+    
+    if (known) {
+        mirror_interfaces_added(parameters);
+        return FALSE;
+    }
+    
+    log_verbose("Introspecting %s for its new interfaces", object_path);
+    
+    g_dbus_connection_call(
+        proxy_state->source_bus,
+        proxy_state->config.source_bus_name,
+        object_path,
+        "org.freedesktop.DBus.Introspectable",
+        "Introspect",
+        NULL,
+        G_VARIANT_TYPE("(s)"),
+        G_DBUS_CALL_FLAGS_NONE,
+        -1,
+        NULL,
+        [](GObject *source, GAsyncResult *res, gpointer user_data) {
+            GVariant *parameters = (GVariant *)user_data;
+            GError *error = NULL;
+            GVariant *xml_variant = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, &error);
+            GDBusNodeInfo *node = NULL;
+            
+            if (xml_variant) {
+                const char *xml_data;
+                g_variant_get(xml_variant, "(&s)", &xml_data);
+                node = g_dbus_node_info_new_for_xml(xml_data, &error);
+                g_variant_unref(xml_variant);
+            }
+            
+            if (node) {
+                for (int i = 0; node->interfaces && node->interfaces[i]; i++) {
+                    GDBusInterfaceInfo *iface = node->interfaces[i];
+                    if (!lookup_interface_info(iface->name)) {
+                        mirrored_interfaces_set(iface->name, iface);
+                    }
+                }
+                g_dbus_node_info_unref(node);
+            } else {
+                log_error("Introspection for InterfacesAdded failed: %s", error->message);
+                g_error_free(error);
+            }
+            
+            // Interfaces still unknown are logged and skipped
+            mirror_interfaces_added(parameters);
+            g_variant_unref(parameters);
+            object_manager_release();
+        },
+        g_variant_ref(parameters));
+    return TRUE;
+}
+
+// Drop a mirrored object whose interfaces have been unregistered (eager
+// mode) or that is served by a subtree (lazy mode)
+static void mirror_object_remove(const char *object_path)
+{
+    log_verbose("Object %s removed", object_path);
+    unregister_proxy_interface(object_path, "org.freedesktop.DBus.Properties");
+    mirrored_objects_set(object_path, NULL, TRUE);
+    if (!proxy_state->config.lazy_objects) return;
+    
+    GList *link = (GList *)g_hash_table_lookup(proxy_state->object_info_cache, object_path);
+    if (link) {
+        g_hash_table_remove(proxy_state->object_info_cache, object_path);
+        object_info_cache_entry_free((ObjectInfoCacheEntry *)link->data);
+        g_queue_delete_link(&proxy_state->object_info_lru, link);
+    }
+    
+    gchar *parent = g_path_get_dirname(object_path);
+    gchar *name = g_path_get_basename(object_path);
+    GPtrArray *children = (GPtrArray *)g_hash_table_lookup(proxy_state->object_children, parent);
+    for (guint i = 0; children && i < children->len; i++) {
+        if (g_strcmp0((const char *)g_ptr_array_index(children, i), name) == 0) {
+            g_ptr_array_remove_index(children, i);
+            break;
+        }
+    }
+    g_free(parent);
+    g_free(name);
+}
+
+// InterfacesRemoved (oas) from the source's ObjectManager
+static void on_interfaces_removed(GVariant *parameters)
+{
+    const char *object_path;
+    const char **removed;
+    
+    g_variant_get(parameters, "(&o^a&s)", &object_path, &removed);
+    
+    GDBusNodeInfo *node = mirrored_object_info(object_path);
+    if (!node) {
+        g_free(removed);
+        return;
+    }
+    
+    GPtrArray *remaining = g_ptr_array_new();
+    for (int i = 0; node->interfaces && node->interfaces[i]; i++) {
+        GDBusInterfaceInfo *iface = node->interfaces[i];
+        if (!g_strv_contains(removed, iface->name)) {
+            g_ptr_array_add(remaining, iface);
+            continue;
+        }
+        if (proxy_state->config.lazy_objects) {
+            if (proxy_state->property_cache) {
+                gchar *key = g_strconcat(object_path, " ", iface->name, NULL);
+                g_hash_table_remove(proxy_state->property_cache, key);
+                g_free(key);
+            }
+        } else {
+            unregister_proxy_interface(object_path, iface->name);
+        }
+        shard_stats()->interfaces_removed++;
+    }
+    
+    if (remaining->len == 0) {
+        mirror_object_remove(object_path);
+    } else {
+        GDBusNodeInfo *updated = object_node_new(object_path, remaining);
+        mirrored_objects_set(object_path, updated, FALSE);
+        if (proxy_state->config.lazy_objects) object_info_cache_insert(object_path, updated);
+        g_dbus_node_info_unref(updated);
+    }
+    
+    g_ptr_array_unref(remaining);
+    g_free(removed);
+}
+
+// Apply an ObjectManager signal to the mirror; TRUE while it waits for
+// an Introspect of its new interfaces
+static gboolean object_manager_apply(const char *signal_name, GVariant *parameters)
+{
+    if (g_strcmp0(signal_name, "InterfacesAdded") == 0 &&
+        g_variant_is_of_type(parameters, G_VARIANT_TYPE("(oa{sa{sv}})"))) {
+        return on_interfaces_added(parameters);
+    } else if (g_strcmp0(signal_name, "InterfacesRemoved") == 0 &&
+               g_variant_is_of_type(parameters, G_VARIANT_TYPE("(oas)"))) {
+        on_interfaces_removed(parameters);
+    }
+    return FALSE;
+}
+
+static void held_object_manager_signal_free(gpointer data)
+{
+    HeldObjectManagerSignal *held = (HeldObjectManagerSignal *)data;
+    
+    g_free(held->signal_name);
+    g_variant_unref(held->parameters);
+    g_free(held);
+}
+
+// Keep the mirror in step with the source's ObjectManager. Returns TRUE if
+// the signal is held back: target clients must not see an object before it
+// is registered, and later signals keep their order behind it.
+static gboolean on_object_manager_signal(const char *signal_name, GVariant *parameters)
+{
+    if (g_queue_is_empty(&proxy_state->object_manager_held) && !object_manager_apply(signal_name, parameters)) {
+        return FALSE;
+    }
+    
+    HeldObjectManagerSignal *held = g_new0(HeldObjectManagerSignal, 1);
+    held->signal_name = g_strdup(signal_name);
+    held->parameters = g_variant_ref(parameters);
+    g_queue_push_tail(&proxy_state->object_manager_held, held);
+    return TRUE;
+}
+
+// The head of the held signals has its object registered: forward it, then
+// apply and forward the ones queued behind it up to the next that has to
+// wait for an Introspect
+static void object_manager_release()
+{
+    HeldObjectManagerSignal *held = (HeldObjectManagerSignal *)g_queue_pop_head(&proxy_state->object_manager_held);
+    
+    while (held) {
+        on_signal_received(NULL, proxy_state->source_owner, proxy_state->object_manager_path,
+                           "org.freedesktop.DBus.ObjectManager", held->signal_name, held->parameters, NULL);
+        held_object_manager_signal_free(held);
+        
+        held = (HeldObjectManagerSignal *)g_queue_peek_head(&proxy_state->object_manager_held);
+        if (!held || object_manager_apply(held->signal_name, held->parameters)) return;
+        g_queue_pop_head(&proxy_state->object_manager_held);
+    }
+}
+
+// Whether two interface infos describe the same interface
+static gboolean interface_info_equal(GDBusInterfaceInfo *a, GDBusInterfaceInfo *b)
+{
+    if (a == b) return TRUE;
+    
+    GString *xml_a = g_string_new(NULL);
+    GString *xml_b = g_string_new(NULL);
+    g_dbus_interface_info_generate_xml(a, 0, xml_a);
+    g_dbus_interface_info_generate_xml(b, 0, xml_b);
+    gboolean equal = g_string_equal(xml_a, xml_b);
+    g_string_free(xml_a, TRUE);
+    g_string_free(xml_b, TRUE);
+    return equal;
+}
+
+// Drop the cached values of an interface whose source process changed; the
+// eager mode seeds it again right away
+static void property_cache_reset(const char *object_path, GDBusInterfaceInfo *iface)
+{
+    if (!proxy_state->property_cache) return;
+    
+    if (proxy_state->config.lazy_objects) {
+        gchar *key = g_strconcat(object_path, " ", iface->name, NULL);
+        g_hash_table_remove(proxy_state->property_cache, key);
+        g_free(key);
+    } else {
+        property_cache_add_interface(object_path, iface);
+        property_cache_seed(object_path, iface);
+    }
+}
+
+// Bring one mirrored object in line with new introspection data, touching
+// only interfaces that differ: removed and changed ones are unregistered,
+// changed and new ones registered, the rest keep their registration and
+// signal subscriptions. An object left without interfaces is removed.
+// reset_properties drops the cached values of the kept interfaces too.
+// Returns the number of interfaces that changed.
+static guint mirror_object_diff(const char *object_path, GDBusNodeInfo *node, gboolean reset_properties)
+{
+    gboolean lazy = proxy_state->config.lazy_objects;
+    gboolean mirrored = g_hash_table_contains(proxy_state->objects, object_path);
+    GDBusNodeInfo *old = NULL;
+    guint changed = 0;
+    
+    // The lazy mode compares against what its LRU still holds, without
+    // introspecting; interfaces of an evicted object all count as changed
+    if (lazy) {
+        GList *link = (GList *)g_hash_table_lookup(proxy_state->object_info_cache, object_path);
+        if (link) old = ((ObjectInfoCacheEntry *)link->data)->node;
+    } else {
+        old = (GDBusNodeInfo *)g_hash_table_lookup(proxy_state->objects, object_path);
+    }
+    if (old) g_dbus_node_info_ref(old);
+    
+    for (int i = 0; old && old->interfaces && old->interfaces[i]; i++) {
+        GDBusInterfaceInfo *iface = old->interfaces[i];
+        GDBusInterfaceInfo *now = g_dbus_node_info_lookup_interface(node, iface->name);
+        if (now && interface_info_equal(iface, now)) {
+            if (reset_properties) property_cache_reset(object_path, now);
+            continue;
+        }
+        log_verbose("Interface %s on %s %s", iface->name, object_path, now ? "changed" : "removed");
+        unregister_proxy_interface(object_path, iface->name);
+        changed++;
+    }
+    
+    if (!node->interfaces || !node->interfaces[0]) {
+        if (mirrored) mirror_object_remove(object_path);
+        if (old) g_dbus_node_info_unref(old);
+        return changed;
+    }
+    
+    mirror_introspected_node(object_path, node, TRUE);
+    
+    for (int i = 0; node->interfaces[i]; i++) {
+        GDBusInterfaceInfo *iface = node->interfaces[i];
+        GDBusInterfaceInfo *before = old ? g_dbus_node_info_lookup_interface(old, iface->name) : NULL;
+        if (before && interface_info_equal(before, iface)) continue;
+        
+        log_verbose("Interface %s on %s %s", iface->name, object_path, before ? "re-registered" : "added");
+        if (lazy) {
+            // Nothing to register, the subtree serves the object. Without
+            // old data the first loop skipped the object, so the property
+            // cache and signal index may still hold the previous owner's
+            // entries for this interface.
+            if (!old) unregister_proxy_interface(object_path, iface->name);
+        } else {
+            register_proxy_interface(object_path, iface);
+        }
+        changed++;
+    }
+    
+    if (lazy) {
+        if (g_strcmp0(object_path, proxy_state->config.source_object_path) != 0) {
+            gchar *parent = g_path_get_dirname(object_path);
+            gchar *name = g_path_get_basename(object_path);
+            object_children_add(parent, name);
+            register_proxy_subtree(parent);
+            g_free(parent);
+            g_free(name);
+        }
+    } else if (!mirrored) {
+        signal_subscription_add(object_path, "org.freedesktop.DBus.Properties", "PropertiesChanged");
+    }
+    
+    if (old) g_dbus_node_info_unref(old);
+    return changed;
+}
+
+// Remove a mirrored object through mirror_object_diff
+static guint mirror_object_vanished(const char *object_path)
+{
+    GPtrArray *none = g_ptr_array_new();
+    GDBusNodeInfo *empty = object_node_new(object_path, none);
+    guint changed = mirror_object_diff(object_path, empty, FALSE);
+    
+    g_dbus_node_info_unref(empty);
+    g_ptr_array_unref(none);
+    return changed;
+}
+
+// Whether node has exactly the interfaces the profile lists for object_path
+static gboolean profile_object_equal(const ProxyProfile *profile, const char *object_path, GDBusNodeInfo *node)
+{
+    guint n_interfaces = 0;
+    
+    while (node->interfaces && node->interfaces[n_interfaces]) n_interfaces++;
+    
+    for (guint i = 0; i < profile->n_objects; i++) {
+        const ProxyProfileObject *object = &profile->objects[i];
+        if (g_strcmp0(object->object_path, object_path) != 0) continue;
+        
+        guint j;
+        for (j = 0; object->interfaces[j]; j++) {
+            GDBusInterfaceInfo *now = g_dbus_node_info_lookup_interface(node, object->interfaces[j]->name);
+            if (!now || !interface_info_equal(object->interfaces[j], now)) return FALSE;
+        }
+        return j == n_interfaces;
+    }
+    
+    return n_interfaces == 0;
+}
+
+// Apply a background revalidation walk: objects whose XML hash changed, or
+// that differ from the profile, are diffed against the mirror, vanished ones
+// removed, and the cache is rewritten. Objects below an ObjectManager are
+// tracked by its signals.
+static void on_revalidation_done(IntrospectWalk *walk)
+{
+    const ProxyProfile *profile = proxy_state->config.profile;
+    const char *what = profile ? "profile" : "introspection cache";
+    guint changed = 0, removed = 0;
+    GHashTableIter iter;
+    gpointer key, value;
+    
+    if (walk->root_failed) {
+        log_error("Revalidation of the %s failed, keeping its data", what);
+        goto out;
+    }
+    
+    g_hash_table_iter_init(&iter, walk->xml);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        const char *object_path = (const char *)key;
+        if (!profile) {
+            gchar *digest = g_compute_checksum_for_string(G_CHECKSUM_SHA256, (const char *)value, -1);
+            gboolean same = g_strcmp0(digest, (const char *)g_hash_table_lookup(proxy_state->introspection_hashes,
+                                                                               object_path)) == 0;
+            g_free(digest);
+            if (same) continue;
+        }
+        
+        GDBusNodeInfo *node = g_dbus_node_info_new_for_xml((const char *)value, NULL);
+        if (!node) continue;
+        // Unchanged profile objects keep their static infos and fast path
+        if (profile && profile_object_equal(profile, object_path, node)) {
+            g_dbus_node_info_unref(node);
+            continue;
+        }
+        
+        log_verbose("Introspection of %s changed", object_path);
+        changed++;
+        mirror_object_diff(object_path, node, FALSE);
+        g_dbus_node_info_unref(node);
+    }
+    
+    if (profile) {
+        for (guint i = 0; i < profile->n_objects; i++) {
+            const char *object_path = profile->objects[i].object_path;
+            if (g_hash_table_contains(walk->xml, object_path)) continue;
+            if (!g_hash_table_contains(proxy_state->objects, object_path)) continue;
+            
+            mirror_object_vanished(object_path);
+            removed++;
+        }
+    } else {
+        g_hash_table_iter_init(&iter, proxy_state->introspection_hashes);
+        while (g_hash_table_iter_next(&iter, &key, NULL)) {
+            const char *object_path = (const char *)key;
+            if (g_hash_table_contains(walk->xml, object_path)) continue;
+            if (!g_hash_table_contains(proxy_state->objects, object_path)) continue;
+            
+            mirror_object_vanished(object_path);
+            removed++;
+        }
+        introspection_cache_store(walk->xml);
+    }
+    
+    log_info("Revalidated %s in %.1f ms: %u object(s) changed, %u removed",
+             what, (g_get_monotonic_time() - walk->started) / 1000.0, changed, removed);
+    
+out:
+    g_hash_table_destroy(walk->xml);
+    g_free(walk);
+}
+
+// Walk the source tree in the background, only collecting XML, and hand
+// the walk to done
+static void introspect_collect(void (*done)(IntrospectWalk *walk))
+{
+    IntrospectWalk *walk = g_new0(IntrospectWalk, 1);
+    
+    g_queue_init(&walk->pending);
+    walk->collect_only = TRUE;
+    walk->xml = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    walk->started = g_get_monotonic_time();
+    walk->done = done;
+    
+    IntrospectRequest *root = g_new0(IntrospectRequest, 1);
+    root->walk = walk;
+    root->object_path = g_strdup(proxy_state->config.source_object_path);
+    g_queue_push_tail(&walk->pending, root);
+    
+    introspect_walk_launch(walk);
+}
+
+// Walk the source tree again in the background after starting from the
+// cache or a profile, without holding up registration or name acquisition
+static void introspection_cache_revalidate()
+{
+    log_verbose("Revalidating %s in the background", proxy_state->config.profile ? "profile" : "introspection cache");
+    introspect_collect(on_revalidation_done);
+}
+
+// Re-discovery after the source name got a new owner. The registrations,
+// the proxy's bus name and calls in flight all stay; only interfaces whose
+// introspection data differs are re-registered.
+static void source_resync_start();
+
+// Forward the calls held while the source was away
+static void source_outage_end()
+{
+    if (!source_outage()) return;
+    
+    g_atomic_int_set(&proxy_state->source_down, FALSE);
+    log_info("Source %s is back, replaying %u held call(s)", proxy_state->config.source_bus_name,
+             g_queue_get_length(&proxy_state->parked_calls));
+    parked_calls_replay();
+}
+
+static void source_resync_finish(guint changed)
+{
+    proxy_state->stats.resync_interfaces_changed += changed;
+    proxy_state->resyncing = FALSE;
+    log_info("Resynchronized with restarted source in %.1f ms: %u interface(s) changed",
+             (g_get_monotonic_time() - proxy_state->resync_started) / 1000.0, changed);
+    
+    // Held calls go out once the mirror matches the new owner
+    if (proxy_state->resync_pending) {
+        source_resync_start();
+    } else {
+        source_outage_end();
+    }
+}
+
+static void on_resync_managed_objects(IntrospectWalk *walk)
+{
+    GVariant *objects = (GVariant *)walk->user_data;
+    guint changed = proxy_state->resync_changed;
+    GHashTable *seen = g_hash_table_new(g_str_hash, g_str_equal);
+    GVariantIter object_iter;
+    const char *object_path;
+    GVariant *interfaces;
+    GHashTableIter iter;
+    gpointer key, value;
+    
+    // Interfaces the new owner described replace the old definitions now;
+    // those whose Introspect failed keep theirs
+    g_hash_table_iter_init(&iter, walk->interfaces);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        mirrored_interfaces_set((const char *)key, (GDBusInterfaceInfo *)value);
+    }
+    g_hash_table_destroy(walk->interfaces);
+    
+    g_variant_iter_init(&object_iter, objects);
+    while (g_variant_iter_next(&object_iter, "{&o@a{sa{sv}}}", &object_path, &interfaces)) {
+        GPtrArray *infos = g_ptr_array_new();
+        GVariantIter iface_iter;
+        const char *interface_name;
+        GVariant *properties;
+        
+        // Values arrive with the reply, so kept interfaces are refreshed
+        // from it rather than seeded again
+        g_variant_iter_init(&iface_iter, interfaces);
+        while (g_variant_iter_next(&iface_iter, "{&s@a{sv}}", &interface_name, &properties)) {
+            GDBusInterfaceInfo *iface = lookup_interface_info(interface_name);
+            if (iface) {
+                g_ptr_array_add(infos, iface);
+                property_cache_preload(object_path, iface, properties);
+            }
+            g_variant_unref(properties);
+        }
+        
+        GDBusNodeInfo *node = object_node_new(object_path, infos);
+        changed += mirror_object_diff(object_path, node, FALSE);
+        g_hash_table_add(seen, (gpointer)object_path);
+        g_dbus_node_info_unref(node);
+        g_ptr_array_unref(infos);
+        g_variant_unref(interfaces);
+    }
+    
+    // Objects the new owner no longer manages
+    gchar *prefix = g_strcmp0(proxy_state->object_manager_path, "/") == 0
+        ? g_strdup("/") : g_strconcat(proxy_state->object_manager_path, "/", NULL);
+    GPtrArray *vanished = g_ptr_array_new_with_free_func(g_free);
+    
+    g_hash_table_iter_init(&iter, proxy_state->objects);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        if (g_str_has_prefix((const char *)key, prefix) && !g_hash_table_contains(seen, key)) {
+            g_ptr_array_add(vanished, g_strdup((const char *)key));
+        }
+    }
+    for (guint i = 0; i < vanished->len; i++) {
+        changed += mirror_object_vanished((const char *)g_ptr_array_index(vanished, i));
+    }
+    
+    g_ptr_array_unref(vanished);
+    g_free(prefix);
+    g_hash_table_destroy(seen);
+    g_variant_unref(objects);
+    g_free(walk);
+    source_resync_finish(changed);
+}
+
+static void on_resync_managed_objects_reply(GObject *source, GAsyncResult *res, gpointer user_data G_GNUC_UNUSED)
+{
+    GError *error = NULL;
+    GVariant *reply = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), res, &error);
     
-    if (result) {
-        GVariant *value;
-        g_variant_get(result, "(v)", &value);
-        g_variant_unref(result);
-        log_verbose("Property get successful");
-        return value;
+    if (!reply) {
+        log_error("GetManagedObjects on restarted source failed, keeping managed objects: %s", error->message);
+        g_error_free(error);
+        source_resync_finish(proxy_state->resync_changed);
+        return;
     }
     
-    log_error("Property get failed: %s", error && *error ? (*error)->message : "Unknown error");
-    return NULL;
+    GVariant *objects = g_variant_get_child_value(reply, 0);
+    g_variant_unref(reply);
+    managed_objects_introspect(objects, TRUE, on_resync_managed_objects);
 }
 
-// Handle property set requests
-static gboolean handle_set_property(GDBusConnection *connection G_GNUC_UNUSED,
-                                    const char *sender,
-                                    const char *object_path G_GNUC_UNUSED,
-                                    const char *interface_name,
-                                    const char *property_name,
-                                    GVariant *value,
-                                    GError **error,
-                                    gpointer user_data G_GNUC_UNUSED)
+static void on_source_resync_walk_done(IntrospectWalk *walk)
 {
-    log_verbose("Property set: %s.%s from %s", interface_name, property_name, sender);
+    guint changed = 0;
+    GHashTableIter iter;
+    gpointer key, value;
+    
+    if (walk->root_failed) {
+        log_error("Introspection of restarted source failed, keeping current objects");
+        g_hash_table_destroy(walk->xml);
+        g_free(walk);
+        source_resync_finish(0);
+        return;
+    }
+    
+    g_hash_table_iter_init(&iter, walk->xml);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        GDBusNodeInfo *node = g_dbus_node_info_new_for_xml((const char *)value, NULL);
+        if (!node) continue;
+        changed += mirror_object_diff((const char *)key, node, TRUE);
+        g_dbus_node_info_unref(node);
+    }
+    
+    // Objects outside an ObjectManager that the new owner does not export
+    gchar *prefix = !proxy_state->object_manager_path ? NULL
+                  : g_strcmp0(proxy_state->object_manager_path, "/") == 0 ? g_strdup("/")
+                  : g_strconcat(proxy_state->object_manager_path, "/", NULL);
+    GPtrArray *vanished = g_ptr_array_new_with_free_func(g_free);
+    g_hash_table_iter_init(&iter, proxy_state->objects);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        if (g_hash_table_contains(walk->xml, key)) continue;
+        if (prefix && g_str_has_prefix((const char *)key, prefix)) continue;
+        g_ptr_array_add(vanished, g_strdup((const char *)key));
+    }
+    for (guint i = 0; i < vanished->len; i++) {
+        changed += mirror_object_vanished((const char *)g_ptr_array_index(vanished, i));
+    }
+    g_ptr_array_unref(vanished);
+    
+    if (proxy_state->introspection_hashes) introspection_cache_store(walk->xml);
+    g_hash_table_destroy(walk->xml);
+    g_free(walk);
+    
+    if (!proxy_state->object_manager_path) {
+        g_free(prefix);
+        source_resync_finish(changed);
+        return;
+    }
+    
+    // Interfaces of managed objects are introspected again, one object per
+    // interface, so changed definitions are picked up. The mirror keeps the
+    // old ones until the new ones are in (on_resync_managed_objects).
+    g_free(prefix);
     
-    // Forward property set to source bus
-    GVariant *result = g_dbus_connection_call_sync(
+    proxy_state->resync_changed = changed;
+    g_dbus_connection_call(
         proxy_state->source_bus,
         proxy_state->config.source_bus_name,
-        proxy_state->config.source_object_path,
-        "org.freedesktop.DBus.Properties",
-        "Set",
-        g_variant_new("(ssv)", interface_name, property_name, value),
+        proxy_state->object_manager_path,
+        "org.freedesktop.DBus.ObjectManager",
+        "GetManagedObjects",
         NULL,
+        G_VARIANT_TYPE("(a{oa{sa{sv}}})"),
         G_DBUS_CALL_FLAGS_NONE,
         -1,
         NULL,
-        error);
-    
-    if (result) {
-        g_variant_unref(result);
-        log_verbose("Property set successful");
-        return TRUE;
+        on_resync_managed_objects_reply,
+        NULL);
+}
+
+static void source_resync_start()
+{
+    if (proxy_state->resyncing) {
+        proxy_state->resync_pending = TRUE;
+        return;
     }
     
-    log_error("Property set failed: %s", error && *error ? (*error)->message : "Unknown error");
-    return FALSE;
+    log_info("Source %s has a new owner, re-introspecting", proxy_state->config.source_bus_name);
+    proxy_state->stats.source_restarts++;
+    proxy_state->resyncing = TRUE;
+    proxy_state->resync_pending = FALSE;
+    proxy_state->resync_started = g_get_monotonic_time();
+    introspect_collect(on_source_resync_walk_done);
 }
 
-// Forward signals from source bus to target bus
-static void on_signal_received(GDBusConnection *connection G_GNUC_UNUSED,
-                               const char *sender_name,
-                               const char *object_path G_GNUC_UNUSED,
-                               const char *interface_name,
-                               const char *signal_name,
-                               GVariant *parameters,
+static void on_source_appeared(GDBusConnection *connection G_GNUC_UNUSED,
+                               const gchar *name,
+                               const gchar *name_owner,
                                gpointer user_data G_GNUC_UNUSED)
 {
-    log_verbose("Signal received: %s.%s from %s", interface_name, signal_name, sender_name);
+    // A source absent at startup that shows up for the first time has
+    // nothing to resynchronize from
+    gboolean restarted = proxy_state->source_owner_seen && g_strcmp0(proxy_state->source_owner, name_owner) != 0;
     
-    GError *error = NULL;
-    gboolean success = g_dbus_connection_emit_signal(
-        proxy_state->target_bus,
-        NULL, // Broadcast to all subscribers
-        proxy_state->config.source_object_path,
-        interface_name,
-        signal_name,
-        parameters,
-        &error);
+    log_verbose("Source %s owned by %s", name, name_owner);
+    g_free(proxy_state->source_owner);
+    proxy_state->source_owner = g_strdup(name_owner);
+    proxy_state->source_owner_seen = TRUE;
     
-    if (success) {
-        log_verbose("Signal forwarded successfully");
+    // After a restart, held calls wait for the resync (source_resync_finish)
+    if (!restarted) {
+        source_outage_end();
+    } else if (proxy_state->startup_phase == STARTUP_READY) {
+        source_resync_start();
     } else {
-        log_error("Failed to forward signal: %s", error ? error->message : "Unknown error");
-        if (error) g_error_free(error);
+        proxy_state->resync_pending = TRUE; // Picked up by startup_ready()
     }
 }
 
-// Handle properties changed signals specially
-static void on_properties_changed(GDBusConnection *connection,
-                                  const char *sender_name,
-                                  const char *object_path,
-                                  const char *interface_name,
-                                  const char *signal_name,
-                                  GVariant *parameters,
-                                  gpointer user_data)
+static void on_source_vanished(GDBusConnection *connection G_GNUC_UNUSED,
+                               const gchar *name,
+                               gpointer user_data G_GNUC_UNUSED)
 {
-    const char *changed_interface;
-    g_variant_get_child(parameters, 0, "&s", &changed_interface);
-    
-    log_verbose("Properties changed signal for interface: %s", changed_interface);
+    if (proxy_state->source_owner) {
+        log_info("Source %s lost its owner, waiting for it to return%s", name,
+                 proxy_state->config.hold_messages > 0 ? "; holding calls" : "");
+    }
+    g_clear_pointer(&proxy_state->source_owner, g_free);
     
-    // Forward the PropertiesChanged signal
-    on_signal_received(connection, sender_name, object_path, interface_name, signal_name, parameters, user_data);
+    if (proxy_state->config.hold_messages > 0) {
+        g_atomic_int_set(&proxy_state->source_down, TRUE);
+    }
 }
 
-// Initialize proxy state
-static gboolean init_proxy_state(const ProxyConfig *config)
+// Resident set size of the proxy in KiB, 0 if unknown
+static guint64 resident_memory_kib()
 {
-    proxy_state = g_new0(ProxyState, 1);
-    proxy_state->config = *config;
-    proxy_state->registered_objects = g_hash_table_new(g_direct_hash, g_direct_equal);
-    proxy_state->signal_subscriptions = g_hash_table_new(g_direct_hash, g_direct_equal);
+    gchar *status = NULL;
+    guint64 rss = 0;
     
-    return TRUE;
+    if (g_file_get_contents("/proc/self/status", &status, NULL, NULL)) {
+        const char *line = strstr(status, "VmRSS:");
+        if (line) rss = g_ascii_strtoull(line + strlen("VmRSS:"), NULL, 10);
+        g_free(status);
+    }
+    return rss;
 }
 
-// Connect to both buses
-static gboolean connect_to_buses()
+// Register interfaces and set up signal forwarding
+static gboolean setup_proxy_interfaces()
 {
-    GError *error = NULL;
-    
-    // Connect to source bus
-    proxy_state->source_bus = g_bus_get_sync(proxy_state->config.source_bus_type, NULL, &error);
-    if (!proxy_state->source_bus) {
-        log_error("Failed to connect to source bus: %s", error->message);
-        g_error_free(error);
+    if (g_hash_table_size(proxy_state->objects) == 0) {
+        log_error("No interfaces found in introspection data");
         return FALSE;
     }
-    log_info("Connected to source bus (%s)", 
-             proxy_state->config.source_bus_type == G_BUS_TYPE_SYSTEM ? "system" : "session");
     
-    // Connect to target bus
-    proxy_state->target_bus = g_bus_get_sync(proxy_state->config.target_bus_type, NULL, &error);
-    if (!proxy_state->target_bus) {
-        log_error("Failed to connect to target bus: %s", error->message);
-        g_error_free(error);
-        return FALSE;
-    }
-    log_info("Connected to target bus (%s)", 
-             proxy_state->config.target_bus_type == G_BUS_TYPE_SYSTEM ? "system" : "session");
+    guint per_signal_rules = 0;
+    GHashTableIter iter;
+    gpointer key, value;
     
-    return TRUE;
-}
-
-// Fetch introspection data from source service
-static gboolean fetch_introspection_data()
-{
-    GError *error = NULL;
+    if (proxy_state->config.lazy_objects) {
+        // Signals are indexed as they arrive, see on_source_signal
+        if (!register_proxy_subtrees()) return FALSE;
+    } else {
+        // Register each discovered object on the target bus
+        g_hash_table_iter_init(&iter, proxy_state->objects);
+        while (g_hash_table_iter_next(&iter, &key, &value)) {
+            gint signals = register_proxy_object((const char *)key, (GDBusNodeInfo *)value);
+            if (signals < 0) return FALSE;
+            per_signal_rules += signals;
+        }
+        log_info("Registered %u object(s) on the target bus", g_hash_table_size(proxy_state->objects));
+    }
+    log_info("Resident memory after registration: %" G_GUINT64_FORMAT " KiB (%s)",
+             resident_memory_kib(), proxy_state->config.lazy_objects ? "lazy" : "eager");
     
-    log_info("Fetching introspection data from %s%s", 
-             proxy_state->config.source_bus_name, 
-             proxy_state->config.source_object_path);
+    // One wildcard subscription (one AddMatch rule in the bus daemon) for
+    // every signal the source sends from the object, or from any of its
+    // objects when the subtree is mirrored; on_source_signal filters against
+    // the signal index
+    const char *match_path = proxy_state->config.introspect_depth > 0 ? NULL
+                                                                       : proxy_state->config.source_object_path;
+    log_verbose("Subscribing to signals from %s on %s",
+                proxy_state->config.source_bus_name, match_path ? match_path : "any path");
     
-    GVariant *xml_variant = g_dbus_connection_call_sync(
+    guint subscription_id = g_dbus_connection_signal_subscribe(
         proxy_state->source_bus,
         proxy_state->config.source_bus_name,
-        proxy_state->config.source_object_path,
-        "org.freedesktop.DBus.Introspectable",
-        "Introspect",
-        NULL,
-        G_VARIANT_TYPE("(s)"),
-        G_DBUS_CALL_FLAGS_NONE,
-        -1,
-        NULL,
-        &error);
+        NULL, // Any interface
+        NULL, // Any member
+        match_path,
+        NULL, // arg0
+        G_DBUS_SIGNAL_FLAGS_NONE,
+        on_source_signal,
+        NULL, // user_data
+        NULL); // user_data_free_func
     
-    if (!xml_variant) {
-        log_error("Introspection failed: %s", error->message);
-        g_error_free(error);
-        return FALSE;
-    }
+    g_array_append_val(proxy_state->signal_match_ids, subscription_id);
     
-    const char *xml_data;
-    g_variant_get(xml_variant, "(s)", &xml_data);
+    // per_signal_rules is what a match rule per signal, plus one PropertiesChanged
+    // rule per object, would have installed
+    log_info("Installed %u signal match rule(s) instead of %u per-signal rules, forwarding %u distinct signal(s)",
+             proxy_state->signal_match_ids->len, per_signal_rules,
+             g_hash_table_size(proxy_state->signal_subscriptions));
     
-    log_verbose("Introspection XML received (%zu bytes)", strlen(xml_data));
+    sender_names_resolve();
     
-    proxy_state->introspection_data = g_dbus_node_info_new_for_xml(xml_data, &error);
-    g_variant_unref(xml_variant);
+    proxy_state->fd_signal_filter_id = g_dbus_connection_add_filter(proxy_state->source_bus,
+                                                                    fd_signal_filter,
+                                                                    NULL, NULL);
     
-    if (!proxy_state->introspection_data) {
-        log_error("Failed to parse introspection XML: %s", error->message);
-        g_error_free(error);
-        return FALSE;
+    if (proxy_state->config.message_forwarding) {
+        proxy_state->message_filter_id = g_dbus_connection_add_filter(proxy_state->target_bus,
+                                                                      message_forwarding_filter,
+                                                                      NULL, NULL);
+        log_info("Message-level forwarding enabled");
     }
     
-    log_info("Introspection data parsed successfully");
+    log_info("All interfaces registered and signal subscriptions set up");
     return TRUE;
 }
 
-// Register interfaces and set up signal forwarding
-static gboolean setup_proxy_interfaces()
+// Startup is complete once the proxy name is ours
+static void startup_ready()
 {
-    if (!proxy_state->introspection_data->interfaces) {
-        log_error("No interfaces found in introspection data");
-        return FALSE;
-    }
+    proxy_state->startup_phase = STARTUP_READY;
     
-    GDBusInterfaceVTable vtable = {
-        .method_call = handle_method_call,
-        .get_property = handle_get_property,
-        .set_property = handle_set_property,
-        .padding = {0} // Initialize padding array
-    };
+    if (proxy_state->resync_pending) {
+        source_resync_start();
+    } else if (proxy_state->started_from_cache || proxy_state->config.profile) {
+        introspection_cache_revalidate();
+    }
     
-    // Register each interface on the target bus
-    for (int i = 0; proxy_state->introspection_data->interfaces[i]; i++) {
-        GDBusInterfaceInfo *iface = proxy_state->introspection_data->interfaces[i];
-        GError *error = NULL;
-        
-        log_info("Registering interface: %s", iface->name);
-        
-        guint registration_id = g_dbus_connection_register_object(
-            proxy_state->target_bus,
-            proxy_state->config.source_object_path,
-            iface,
-            &vtable,
-            NULL, // user_data
-            NULL, // user_data_free_func
-            &error);
-        
-        if (registration_id == 0) {
-            log_error("Failed to register interface %s: %s", iface->name, error->message);
-            g_error_free(error);
-            return FALSE;
-        }
-        
-        g_hash_table_insert(proxy_state->registered_objects, 
-                           GUINT_TO_POINTER(registration_id), 
-                           g_strdup(iface->name));
-        
-        // Subscribe to all signals for this interface
-        if (iface->signals) {
-            for (int j = 0; iface->signals[j]; j++) {
-                log_verbose("Subscribing to signal: %s.%s", iface->name, iface->signals[j]->name);
-                
-                guint subscription_id = g_dbus_connection_signal_subscribe(
-                    proxy_state->source_bus,
-                    proxy_state->config.source_bus_name,
-                    iface->name,
-                    iface->signals[j]->name,
-                    proxy_state->config.source_object_path,
-                    NULL, // arg0
-                    G_DBUS_SIGNAL_FLAGS_NONE,
-                    on_signal_received,
-                    NULL, // user_data
-                    NULL); // user_data_free_func
-                
-                g_hash_table_insert(proxy_state->signal_subscriptions,
-                                   GUINT_TO_POINTER(subscription_id),
-                                   g_strdup_printf("%s.%s", iface->name, iface->signals[j]->name));
-            }
-        }
+    if (proxy_state->config.stats_interval > 0) {
+        g_timeout_add_seconds(proxy_state->config.stats_interval,
+                              [](gpointer) -> gboolean {
+                                  log_stats();
+                                  return G_SOURCE_CONTINUE;
+                              },
+                              NULL);
     }
     
-    // Subscribe to PropertiesChanged signals
-    guint props_subscription_id = g_dbus_connection_signal_subscribe(
-        proxy_state->source_bus,
-        proxy_state->config.source_bus_name,
-        "org.freedesktop.DBus.Properties",
-        "PropertiesChanged",
-        proxy_state->config.source_object_path,
-        NULL,
-        G_DBUS_SIGNAL_FLAGS_NONE,
-        on_properties_changed,
-        NULL,
-        NULL);
+    log_info("Cross-bus proxy is running and ready to forward calls (%.1f ms to ready)",
+             (g_get_monotonic_time() - proxy_state->startup_started) / 1000.0);
+    log_info("Press Ctrl+C to stop");
+}
+
+static void on_name_acquired(GDBusConnection *connection G_GNUC_UNUSED, const gchar *name, gpointer user_data)
+{
+    log_info("Bus name acquired: %s", name);
+    if (proxy_state->startup_phase == STARTUP_READY) return;
     
-    g_hash_table_insert(proxy_state->signal_subscriptions,
-                       GUINT_TO_POINTER(props_subscription_id),
-                       g_strdup("org.freedesktop.DBus.Properties.PropertiesChanged"));
+    log_startup_phase("acquired bus name", *(gint64 *)user_data);
+    startup_ready();
+}
+
+static void on_name_lost(GDBusConnection *connection G_GNUC_UNUSED, const gchar *name, gpointer user_data G_GNUC_UNUSED)
+{
+    if (proxy_state->startup_phase != STARTUP_READY) {
+        log_error("Failed to acquire bus name: %s", name);
+        startup_fail("bus name");
+        return;
+    }
     
-    log_info("All interfaces registered and signal subscriptions set up");
-    return TRUE;
+    log_error("Lost bus name %s, shutting down", name);
+    proxy_state->exit_status = 1;
+    g_main_loop_quit(proxy_state->main_loop);
 }
 
-// Acquire bus name on target bus
-static gboolean acquire_bus_name()
+// Request the proxy name on the target bus; startup continues in
+// on_name_acquired (or fails in on_name_lost)
+static void acquire_bus_name()
 {
     log_info("Acquiring bus name: %s", proxy_state->config.proxy_bus_name);
+    proxy_state->startup_phase = STARTUP_ACQUIRING_NAME;
+    
+    gint64 *phase_started = g_new(gint64, 1);
+    *phase_started = g_get_monotonic_time();
     
-    guint name_id = g_bus_own_name(
-        proxy_state->config.target_bus_type,
+    proxy_state->name_owner_id = g_bus_own_name_on_connection(
+        proxy_state->target_bus,
         proxy_state->config.proxy_bus_name,
         G_BUS_NAME_OWNER_FLAGS_NONE,
-        NULL, // bus_acquired_handler
-        NULL, // name_acquired_handler  
-        NULL, // name_lost_handler
-        NULL, // user_data
-        NULL); // user_data_free_func
+        on_name_acquired,
+        on_name_lost,
+        phase_started,
+        g_free);
+}
+
+// Register once discovery is done and the target bus and private source
+// connections are up, whichever comes last
+static void startup_maybe_register()
+{
+    if (proxy_state->exit_status || !proxy_state->introspected || !proxy_state->target_bus ||
+        !proxy_state->lanes_ready) {
+        return;
+    }
     
-    if (name_id == 0) {
-        log_error("Failed to acquire bus name: %s", proxy_state->config.proxy_bus_name);
-        return FALSE;
+    proxy_state->startup_phase = STARTUP_REGISTERING;
+    gint64 phase_started = g_get_monotonic_time();
+    
+    if (!setup_proxy_interfaces()) {
+        startup_fail("registration");
+        return;
     }
+    log_startup_phase("registered objects", phase_started);
     
-    log_info("Bus name acquired successfully");
-    return TRUE;
+    acquire_bus_name();
+}
+
+// Every private source connection is up: start the shard threads
+static void source_lanes_ready()
+{
+    for (guint i = 0; proxy_state->shards && i < proxy_state->shards->len; i++) {
+        ProxyShard *shard = (ProxyShard *)g_ptr_array_index(proxy_state->shards, i);
+        gchar *name = g_strdup_printf("proxy-shard-%u", i);
+        shard->thread = g_thread_new(name, shard_thread_main, shard);
+        g_free(name);
+    }
+    
+    if (proxy_state->shards) {
+        log_info("Started %u forwarding shard(s)", proxy_state->shards->len);
+    } else {
+        log_info("Forwarding over %u source connection(s)%s", proxy_state->source_lanes->len,
+                 proxy_state->bulk_lane ? " plus a bulk lane" : "");
+    }
+    log_startup_phase("opened source connections", proxy_state->lanes_started);
+    
+    proxy_state->lanes_ready = TRUE;
+    startup_maybe_register();
+}
+
+static void introspection_done(gboolean ok)
+{
+    if (proxy_state->exit_status) return;
+    
+    if (!ok) {
+        startup_fail("introspection");
+        return;
+    }
+    
+    log_startup_phase("discovered source objects", proxy_state->startup_started);
+    proxy_state->introspected = TRUE;
+    startup_maybe_register();
 }
 
 // Cleanup function
@@ -430,32 +5295,145 @@ static void cleanup_proxy_state()
 {
     if (!proxy_state) return;
     
+    log_stats();
+    
+    if (proxy_state->name_owner_id) {
+        g_bus_unown_name(proxy_state->name_owner_id);
+    }
+    
+    if (proxy_state->source_watch_id) {
+        g_bus_unwatch_name(proxy_state->source_watch_id);
+    }
+    g_free(proxy_state->source_owner);
+    
+    if (proxy_state->parked_timeout_id) {
+        g_source_remove(proxy_state->parked_timeout_id);
+    }
+    ParkedCall *parked;
+    while ((parked = (ParkedCall *)g_queue_pop_head(&proxy_state->parked_calls))) {
+        parked_call_fail(parked, "Proxy is shutting down");
+    }
+    
+    if (proxy_state->message_filter_id) {
+        g_dbus_connection_remove_filter(proxy_state->target_bus, proxy_state->message_filter_id);
+    }
+    
+    if (proxy_state->fd_signal_filter_id) {
+        g_dbus_connection_remove_filter(proxy_state->source_bus, proxy_state->fd_signal_filter_id);
+    }
+    
+    GHashTableIter watch_iter;
+    gpointer watch_id;
+    g_hash_table_iter_init(&watch_iter, proxy_state->name_watches);
+    while (g_hash_table_iter_next(&watch_iter, NULL, &watch_id)) {
+        if (watch_id) g_dbus_connection_signal_unsubscribe(proxy_state->target_bus, GPOINTER_TO_UINT(watch_id));
+    }
+    
     // Unregister objects
     if (proxy_state->registered_objects) {
         GHashTableIter iter;
         gpointer key, value;
         g_hash_table_iter_init(&iter, proxy_state->registered_objects);
         while (g_hash_table_iter_next(&iter, &key, &value)) {
-            g_dbus_connection_unregister_object(proxy_state->target_bus, GPOINTER_TO_UINT(key));
-            g_free(value);
+            g_dbus_connection_unregister_object(proxy_state->target_bus, GPOINTER_TO_UINT(value));
         }
         g_hash_table_destroy(proxy_state->registered_objects);
     }
     
     // Unsubscribe from signals
+    if (proxy_state->signal_match_ids) {
+        for (guint i = 0; i < proxy_state->signal_match_ids->len; i++) {
+            g_dbus_connection_signal_unsubscribe(proxy_state->source_bus,
+                                                 g_array_index(proxy_state->signal_match_ids, guint, i));
+        }
+        g_array_free(proxy_state->signal_match_ids, TRUE);
+    }
     if (proxy_state->signal_subscriptions) {
+        g_hash_table_destroy(proxy_state->signal_subscriptions);
+    }
+    
+    if (proxy_state->property_cache) {
+        g_hash_table_destroy(proxy_state->property_cache);
+    }
+    
+    if (proxy_state->pending_properties) {
+        g_hash_table_destroy(proxy_state->pending_properties);
+    }
+    
+    signal_queue_clear(&proxy_state->signal_queue);
+    
+    stop_shards();
+    
+    g_hash_table_destroy(proxy_state->caller_calls);
+    g_hash_table_destroy(proxy_state->name_watches);
+    
+    for (guint c = 0; c < PRIORITY_CLASSES; c++) {
+        SenderLane *lane;
+        while ((lane = (SenderLane *)g_queue_pop_head(&proxy_state->admission.active[c]))) {
+            AdmissionWaiter *waiter;
+            while ((waiter = (AdmissionWaiter *)g_queue_pop_head(&lane->waiting))) {
+                if (waiter->call->invocation) {
+                    g_dbus_method_invocation_return_dbus_error(waiter->call->invocation, ADMISSION_REJECTED_ERROR,
+                                                               "Proxy is shutting down");
+                } else {
+                    g_object_unref(waiter->call->message);
+                }
+                g_free(waiter->call);
+                g_free(waiter);
+            }
+        }
+    }
+    g_hash_table_destroy(proxy_state->admission.senders);
+    g_hash_table_destroy(proxy_state->admission.weights);
+    g_hash_table_destroy(proxy_state->admission.priority_owners);
+    g_free(proxy_state->breaker_error);
+    
+    if (proxy_state->source_lanes) {
+        g_ptr_array_unref(proxy_state->source_lanes);
+    }
+    
+    if (proxy_state->bulk_lane) {
+        source_lane_free(proxy_state->bulk_lane);
+        g_hash_table_destroy(proxy_state->bulk_methods);
+    }
+    
+    if (proxy_state->registered_subtrees) {
         GHashTableIter iter;
-        gpointer key, value;
-        g_hash_table_iter_init(&iter, proxy_state->signal_subscriptions);
-        while (g_hash_table_iter_next(&iter, &key, &value)) {
-            g_dbus_connection_signal_unsubscribe(proxy_state->source_bus, GPOINTER_TO_UINT(key));
-            g_free(value);
+        gpointer value;
+        g_hash_table_iter_init(&iter, proxy_state->registered_subtrees);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            g_dbus_connection_unregister_subtree(proxy_state->target_bus, GPOINTER_TO_UINT(value));
         }
-        g_hash_table_destroy(proxy_state->signal_subscriptions);
+        g_hash_table_destroy(proxy_state->registered_subtrees);
+    }
+    
+    g_free(proxy_state->object_manager_path);
+    g_queue_clear_full(&proxy_state->object_manager_held, held_object_manager_signal_free);
+    
+    if (proxy_state->profile_method_calls) {
+        g_ptr_array_unref(proxy_state->profile_method_names);
+        g_free(proxy_state->profile_method_calls);
+    }
+    
+    if (proxy_state->introspection_hashes) {
+        g_hash_table_destroy(proxy_state->introspection_hashes);
     }
     
-    if (proxy_state->introspection_data) {
-        g_dbus_node_info_unref(proxy_state->introspection_data);
+    if (proxy_state->object_info_cache) {
+        g_hash_table_destroy(proxy_state->object_info_cache);
+    }
+    g_queue_clear_full(&proxy_state->object_info_lru, (GDestroyNotify)object_info_cache_entry_free);
+    
+    if (proxy_state->object_children) {
+        g_hash_table_destroy(proxy_state->object_children);
+    }
+    
+    if (proxy_state->objects) {
+        g_hash_table_destroy(proxy_state->objects);
+    }
+    
+    if (proxy_state->interfaces) {
+        g_hash_table_destroy(proxy_state->interfaces);
     }
     
     if (proxy_state->source_bus) {
@@ -466,16 +5444,24 @@ static void cleanup_proxy_state()
         g_object_unref(proxy_state->target_bus);
     }
     
+    // Containers filled by the option parser; their strings point into argv
+    g_ptr_array_unref(proxy_state->config.bulk_methods);
+    g_hash_table_destroy(proxy_state->config.coalesce_windows);
+    g_hash_table_destroy(proxy_state->config.sender_weights);
+    g_ptr_array_unref(proxy_state->config.priority_rules);
+    g_hash_table_destroy(proxy_state->config.method_timeouts);
+    
     g_free(proxy_state);
     proxy_state = NULL;
 }
 
-// Signal handler for graceful shutdown
-static void signal_handler(int signum)
+// SIGINT/SIGTERM, dispatched on the main loop; main() cleans up once the
+// loop has stopped, so shards are never joined from a signal context
+static gboolean on_quit_signal(gpointer user_data)
 {
-    log_info("Received signal %d, shutting down...", signum);
-    cleanup_proxy_state();
-    exit(0);
+    log_info("Received signal %d, shutting down...", GPOINTER_TO_INT(user_data));
+    g_main_loop_quit(proxy_state->main_loop);
+    return G_SOURCE_CONTINUE;
 }
 
 // Parse bus type from string
@@ -489,6 +5475,42 @@ static GBusType parse_bus_type(const char *bus_str)
     return G_BUS_TYPE_SYSTEM; // Default
 }
 
+// Parse signal queue policy from string
+static SignalQueuePolicy parse_signal_queue_policy(const char *policy_str)
+{
+    if (g_strcmp0(policy_str, "block") == 0) {
+        return SIGNAL_QUEUE_BLOCK;
+    } else if (g_strcmp0(policy_str, "coalesce") == 0) {
+        return SIGNAL_QUEUE_COALESCE;
+    }
+    return SIGNAL_QUEUE_DROP_OLDEST; // Default
+}
+
+// Parse a --priority rule, KIND:NAME=CLASS; NULL when malformed. NAME
+// points into spec.
+static PriorityRule *parse_priority_rule(char *spec)
+{
+    static const char *const kinds[] = { "interface:", "member:", "sender:" };
+    char *separator = strrchr(spec, '=');
+    if (!separator) return NULL;
+    
+    guint kind = 0;
+    while (kind < G_N_ELEMENTS(kinds) && !g_str_has_prefix(spec, kinds[kind])) kind++;
+    guint priority = 0;
+    while (priority < PRIORITY_CLASSES && g_strcmp0(separator + 1, priority_class_names[priority]) != 0) priority++;
+    if (kind == G_N_ELEMENTS(kinds) || priority == PRIORITY_CLASSES) return NULL;
+    
+    const char *name = spec + strlen(kinds[kind]);
+    if (name >= separator) return NULL;
+    *separator = '\0';
+    
+    PriorityRule *rule = g_new0(PriorityRule, 1);
+    rule->match = (PriorityMatch)kind;
+    rule->name = name;
+    rule->priority = (PriorityClass)priority;
+    return rule;
+}
+
 // Print usage information
 static void print_usage(const char *program_name)
 {
@@ -500,6 +5522,44 @@ static void print_usage(const char *program_name)
     g_print("  --proxy-bus-name NAME      Proxy bus name (example: org.example.Proxy)\n");
     g_print("  --source-bus-type TYPE     Source bus type: system|session (default: system)\n");
     g_print("  --target-bus-type TYPE     Target bus type: system|session (default: session)\n");
+    g_print("  --introspect-depth N       Mirror objects up to N levels below the source path (default: all, 0 = root only)\n");
+    g_print("  --introspect-concurrency N Introspect calls in flight during discovery (default: 16)\n");
+    g_print("  --lazy-objects             Serve the subtree through subtree registrations, introspecting on demand\n");
+    g_print("  --object-cache-size N      Objects whose introspection data the lazy mode keeps (default: 256)\n");
+    g_print("  --no-object-manager        Discover objects by introspection even if the source has an ObjectManager\n");
+    g_print("  --introspection-cache DIR  Start from introspection data cached in DIR, revalidated in the background\n");
+    g_print("  --profile NAME             Use the compiled-in introspection data of profile NAME (available:");
+    for (int i = 0; proxy_profiles[i]; i++) g_print(" %s", proxy_profiles[i]->name);
+    g_print(proxy_profiles[0] ? ")\n" : " none)\n");
+    g_print("  --no-property-cache        Forward every property read to the source\n");
+    g_print("  --message-forwarding       Relay method calls at the message level (no vtable dispatch)\n");
+    g_print("  --source-pool-size N       Private source connections for forwarded calls (default: 0, shared)\n");
+    g_print("  --bulk-method IFACE.METHOD Route a method to a separate bulk connection (repeatable)\n");
+    g_print("  --shards N                 Forward calls and emit signals on N worker threads (default: 0)\n");
+    g_print("  --signal-queue-messages N  Bound queued outgoing signals to N messages (default: 0, unbounded)\n");
+    g_print("  --signal-queue-bytes N     Bound queued outgoing signals to N body bytes (default: 0, unbounded)\n");
+    g_print("  --signal-queue-policy P    When full: block|drop-oldest|coalesce (default: drop-oldest)\n");
+    g_print("  --coalesce-properties IFACE=MS\n");
+    g_print("                             Merge PropertiesChanged bursts of IFACE within MS milliseconds (repeatable)\n");
+    g_print("  --max-in-flight N          Adaptive limit of calls in flight to the source, at most N (default: 0, no limit)\n");
+    g_print("  --admission-queue N        Calls waiting for the in-flight limit before new ones are rejected (default: 1024)\n");
+    g_print("  --latency-target MS        Replies slower than MS shrink the in-flight limit (default: 100)\n");
+    g_print("  --sender-weight NAME=W     Fair queueing weight of a target client, by well-known or unique name (repeatable)\n");
+    g_print("  --priority KIND:NAME=CLASS Priority class (interactive, normal, background) of calls and signals\n");
+    g_print("                             by interface, member or sender; first match wins (repeatable)\n");
+    g_print("  --priority-starvation N    Serve a waiting lower class after N picks of higher ones (default: 8, 0 = strict)\n");
+    g_print("  --call-timeout MS          Timeout of forwarded calls (default: -1, the GDBus default of 25 s)\n");
+    g_print("  --method-timeout NAME=MS   Timeout for INTERFACE.METHOD or a whole INTERFACE (repeatable)\n");
+    g_print("  --hold-messages N          Hold up to N calls while the source name has no owner (default: 0, fail them)\n");
+    g_print("  --hold-bytes N             Bound held calls to N body bytes (default: 0, unbounded)\n");
+    g_print("  --hold-timeout MS          Fail a held call after MS milliseconds (default: 5000)\n");
+    g_print("  --breaker-error-rate PCT   Open the circuit breaker when PCT%% of calls fail (default: 0, off)\n");
+    g_print("  --breaker-latency MS       Open the circuit breaker when mean reply latency exceeds MS (default: 0, off)\n");
+    g_print("  --breaker-window MS        Window the breaker measures failures and latency over (default: 10000)\n");
+    g_print("  --breaker-min-calls N      Calls in a window before the breaker can open (default: 20)\n");
+    g_print("  --breaker-cooldown MS      Time the breaker stays open before probing the source (default: 5000)\n");
+    g_print("  --breaker-probes N         Probe calls that must succeed to close the breaker (default: 3)\n");
+    g_print("  --stats-interval SECONDS   Log runtime counters periodically (default: off)\n");
     g_print("  --verbose                  Enable verbose logging\n");
     g_print("  --help                     Show this help message\n");
 }
@@ -530,7 +5590,41 @@ int main(int argc, char *argv[])
         .proxy_bus_name = "",
         .source_bus_type = G_BUS_TYPE_SYSTEM,
         .target_bus_type = G_BUS_TYPE_SESSION,
-        .verbose = FALSE
+        .verbose = FALSE,
+        .property_cache = TRUE,
+        .message_forwarding = FALSE,
+        .source_pool_size = 0,
+        .bulk_methods = g_ptr_array_new(),
+        .shards = 0,
+        .coalesce_windows = g_hash_table_new(g_str_hash, g_str_equal),
+        .signal_queue_messages = 0,
+        .signal_queue_bytes = 0,
+        .signal_queue_policy = SIGNAL_QUEUE_DROP_OLDEST,
+        .introspect_depth = G_MAXUINT,
+        .introspect_concurrency = 16,
+        .lazy_objects = FALSE,
+        .object_cache_size = 256,
+        .object_manager = TRUE,
+        .introspection_cache_dir = NULL,
+        .profile = NULL,
+        .max_in_flight = 0,
+        .admission_queue = 1024,
+        .latency_target_ms = 100,
+        .sender_weights = g_hash_table_new(g_str_hash, g_str_equal),
+        .priority_rules = g_ptr_array_new_with_free_func(g_free),
+        .priority_starvation = 8,
+        .call_timeout_ms = -1,
+        .method_timeouts = g_hash_table_new(g_str_hash, g_str_equal),
+        .hold_messages = 0,
+        .hold_bytes = 0,
+        .hold_timeout_ms = 5000,
+        .breaker_error_rate = 0,
+        .breaker_latency_ms = 0,
+        .breaker_window_ms = 10000,
+        .breaker_min_calls = 20,
+        .breaker_cooldown_ms = 5000,
+        .breaker_probes = 3,
+        .stats_interval = 0
     };
     
     // Parse command line arguments
@@ -545,6 +5639,120 @@ int main(int argc, char *argv[])
             config.source_bus_type = parse_bus_type(argv[++i]);
         } else if (g_strcmp0(argv[i], "--target-bus-type") == 0 && i + 1 < argc) {
             config.target_bus_type = parse_bus_type(argv[++i]);
+        } else if (g_strcmp0(argv[i], "--no-property-cache") == 0) {
+            config.property_cache = FALSE;
+        } else if (g_strcmp0(argv[i], "--message-forwarding") == 0) {
+            config.message_forwarding = TRUE;
+        } else if (g_strcmp0(argv[i], "--source-pool-size") == 0 && i + 1 < argc) {
+            config.source_pool_size = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--bulk-method") == 0 && i + 1 < argc) {
+            g_ptr_array_add(config.bulk_methods, argv[++i]);
+        } else if (g_strcmp0(argv[i], "--shards") == 0 && i + 1 < argc) {
+            config.shards = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--signal-queue-messages") == 0 && i + 1 < argc) {
+            config.signal_queue_messages = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--signal-queue-bytes") == 0 && i + 1 < argc) {
+            config.signal_queue_bytes = (gsize)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--signal-queue-policy") == 0 && i + 1 < argc) {
+            config.signal_queue_policy = parse_signal_queue_policy(argv[++i]);
+        } else if (g_strcmp0(argv[i], "--coalesce-properties") == 0 && i + 1 < argc) {
+            char *spec = argv[++i];
+            char *separator = strrchr(spec, '=');
+            guint window_ms = separator ? (guint)g_ascii_strtoull(separator + 1, NULL, 10) : 0;
+            if (!separator || separator == spec || window_ms == 0) {
+                log_error("Invalid --coalesce-properties value: %s (expected INTERFACE=MS)", spec);
+                return 1;
+            }
+            *separator = '\0';
+            g_hash_table_replace(config.coalesce_windows, spec, GUINT_TO_POINTER(window_ms));
+        } else if (g_strcmp0(argv[i], "--max-in-flight") == 0 && i + 1 < argc) {
+            config.max_in_flight = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--admission-queue") == 0 && i + 1 < argc) {
+            config.admission_queue = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--latency-target") == 0 && i + 1 < argc) {
+            config.latency_target_ms = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+            if (config.latency_target_ms == 0) {
+                log_error("Invalid --latency-target value: %s (expected MS)", argv[i]);
+                return 1;
+            }
+        } else if (g_strcmp0(argv[i], "--sender-weight") == 0 && i + 1 < argc) {
+            char *spec = argv[++i];
+            char *separator = strrchr(spec, '=');
+            guint weight = separator ? (guint)g_ascii_strtoull(separator + 1, NULL, 10) : 0;
+            if (!separator || separator == spec || weight == 0) {
+                log_error("Invalid --sender-weight value: %s (expected NAME=WEIGHT)", spec);
+                return 1;
+            }
+            *separator = '\0';
+            g_hash_table_replace(config.sender_weights, spec, GUINT_TO_POINTER(weight));
+        } else if (g_strcmp0(argv[i], "--priority") == 0 && i + 1 < argc) {
+            PriorityRule *rule = parse_priority_rule(argv[++i]);
+            if (!rule) {
+                log_error("Invalid --priority value: %s (expected interface:NAME, member:NAME or sender:NAME"
+                          "=interactive|normal|background)", argv[i]);
+                return 1;
+            }
+            g_ptr_array_add(config.priority_rules, rule);
+        } else if (g_strcmp0(argv[i], "--priority-starvation") == 0 && i + 1 < argc) {
+            config.priority_starvation = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--call-timeout") == 0 && i + 1 < argc) {
+            config.call_timeout_ms = (gint)g_ascii_strtoll(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--method-timeout") == 0 && i + 1 < argc) {
+            char *spec = argv[++i];
+            char *separator = strrchr(spec, '=');
+            gint timeout_ms = separator ? (gint)g_ascii_strtoll(separator + 1, NULL, 10) : 0;
+            if (!separator || separator == spec || timeout_ms <= 0) {
+                log_error("Invalid --method-timeout value: %s (expected INTERFACE[.METHOD]=MS)", spec);
+                return 1;
+            }
+            *separator = '\0';
+            g_hash_table_replace(config.method_timeouts, spec, GINT_TO_POINTER(timeout_ms));
+        } else if (g_strcmp0(argv[i], "--hold-messages") == 0 && i + 1 < argc) {
+            config.hold_messages = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--hold-bytes") == 0 && i + 1 < argc) {
+            config.hold_bytes = (gsize)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--hold-timeout") == 0 && i + 1 < argc) {
+            config.hold_timeout_ms = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+            if (config.hold_timeout_ms == 0) {
+                log_error("Invalid --hold-timeout value: %s (expected MS)", argv[i]);
+                return 1;
+            }
+        } else if (g_strcmp0(argv[i], "--breaker-error-rate") == 0 && i + 1 < argc) {
+            config.breaker_error_rate = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--breaker-latency") == 0 && i + 1 < argc) {
+            config.breaker_latency_ms = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--breaker-window") == 0 && i + 1 < argc) {
+            config.breaker_window_ms = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--breaker-min-calls") == 0 && i + 1 < argc) {
+            config.breaker_min_calls = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--breaker-cooldown") == 0 && i + 1 < argc) {
+            config.breaker_cooldown_ms = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--breaker-probes") == 0 && i + 1 < argc) {
+            config.breaker_probes = MAX(1, (guint)g_ascii_strtoull(argv[++i], NULL, 10));
+        } else if (g_strcmp0(argv[i], "--stats-interval") == 0 && i + 1 < argc) {
+            config.stats_interval = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--introspect-depth") == 0 && i + 1 < argc) {
+            config.introspect_depth = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--introspect-concurrency") == 0 && i + 1 < argc) {
+            config.introspect_concurrency = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--lazy-objects") == 0) {
+            config.lazy_objects = TRUE;
+        } else if (g_strcmp0(argv[i], "--object-cache-size") == 0 && i + 1 < argc) {
+            config.object_cache_size = (guint)g_ascii_strtoull(argv[++i], NULL, 10);
+        } else if (g_strcmp0(argv[i], "--no-object-manager") == 0) {
+            config.object_manager = FALSE;
+        } else if (g_strcmp0(argv[i], "--introspection-cache") == 0 && i + 1 < argc) {
+            config.introspection_cache_dir = argv[++i];
+        } else if (g_strcmp0(argv[i], "--profile") == 0 && i + 1 < argc) {
+            const char *name = argv[++i];
+            config.profile = NULL;
+            for (int j = 0; proxy_profiles[j]; j++) {
+                if (g_strcmp0(proxy_profiles[j]->name, name) == 0) config.profile = proxy_profiles[j];
+            }
+            if (!config.profile) {
+                log_error("Unknown profile: %s", name);
+                return 1;
+            }
         } else if (g_strcmp0(argv[i], "--verbose") == 0) {
             config.verbose = TRUE;
         } else if (g_strcmp0(argv[i], "--help") == 0 || g_strcmp0(argv[i], "-h") == 0 || argc == 1) {
@@ -553,13 +5761,20 @@ int main(int argc, char *argv[])
         }
     }
 
+    // A profile is generated for one object path, which it implies
+    if (config.profile) {
+        if (!strlen(config.source_object_path)) {
+            config.source_object_path = config.profile->source_object_path;
+        } else if (g_strcmp0(config.source_object_path, config.profile->source_object_path) != 0) {
+            log_error("Profile %s was generated for %s, not %s", config.profile->name,
+                      config.profile->source_object_path, config.source_object_path);
+            return 1;
+        }
+    }
+    
     // Validate configuration
     validateProxyConfigOrExit(config);
     
-    // Set up signal handlers
-    signal(SIGINT, signal_handler);
-    signal(SIGTERM, signal_handler);
-    
     log_info("Starting cross-bus D-Bus proxy");
     log_info("Source: %s%s on %s bus", 
              config.source_bus_name, 
@@ -575,40 +5790,25 @@ int main(int argc, char *argv[])
         return 1;
     }
     
-    // Connect to both buses
-    if (!connect_to_buses()) {
-        cleanup_proxy_state();
-        return 1;
-    }
-    
-    // Fetch introspection data from source
-    if (!fetch_introspection_data()) {
-        cleanup_proxy_state();
-        return 1;
-    }
-    
-    // Set up proxy interfaces and signal forwarding
-    if (!setup_proxy_interfaces()) {
-        cleanup_proxy_state();
-        return 1;
-    }
-    
-    // Acquire bus name on target bus
-    if (!acquire_bus_name()) {
-        cleanup_proxy_state();
-        return 1;
-    }
+    // Start up asynchronously; the steps chain through their callbacks
+    proxy_state->main_loop = g_main_loop_new(NULL, FALSE);
+    proxy_state->startup_started = g_get_monotonic_time();
+    connect_to_buses();
     
-    log_info("Cross-bus proxy is running and ready to forward calls");
-    log_info("Press Ctrl+C to stop");
+    // Set up signal handlers
+    guint sigint_id = g_unix_signal_add(SIGINT, on_quit_signal, GINT_TO_POINTER(SIGINT));
+    guint sigterm_id = g_unix_signal_add(SIGTERM, on_quit_signal, GINT_TO_POINTER(SIGTERM));
     
     // Run main loop
-    GMainLoop *loop = g_main_loop_new(NULL, FALSE);
+    GMainLoop *loop = proxy_state->main_loop;
     g_main_loop_run(loop);
+    int exit_status = proxy_state->exit_status;
     
     // Cleanup
-    g_main_loop_unref(loop);
+    g_source_remove(sigint_id);
+    g_source_remove(sigterm_id);
     cleanup_proxy_state();
+    g_main_loop_unref(loop);
     
-    return 0;
+    return exit_status;
 }
\ No newline at end of file
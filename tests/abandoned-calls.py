@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+# Callers that leave while their calls are still in flight must not leave
+# pending state behind in the proxy. 100 clients each send 10 slow calls
+# through the proxy (method calls and Properties Get, GetAll and Set, which
+# take the forwarding path of their own) and disconnect at once. Every one
+# of the 1,000 forwarded calls must be cancelled well before the source
+# would have replied, and the proxy must be back to the descriptors it had.
+#
+#   dbus-run-session -- python3 tests/abandoned-calls.py [path/to/dbus-proxy]
+
+import sys
+import time
+
+from gi.repository import Gio, GLib
+
+import proxytest
+
+CALLERS = 100
+CALLS_PER_CALLER = 10
+SLOW_MS = 30000
+
+
+def abandon_calls(connection):
+    iface = proxytest.SERVICE_INTERFACE
+    calls = [
+        (iface, "Sleep", GLib.Variant("(u)", (SLOW_MS,))),
+        ("org.freedesktop.DBus.Properties", "Get", GLib.Variant("(ss)", (iface, "SlowValue"))),
+        ("org.freedesktop.DBus.Properties", "GetAll", GLib.Variant("(s)", (iface,))),
+        ("org.freedesktop.DBus.Properties", "Set",
+         GLib.Variant("(ssv)", (iface, "SlowValue", GLib.Variant("s", "abandoned")))),
+    ]
+    for i in range(CALLS_PER_CALLER):
+        interface, method, parameters = calls[i % len(calls)]
+        connection.call(proxytest.PROXY_NAME, proxytest.SERVICE_PATH, interface, method, parameters,
+                        None, Gio.DBusCallFlags.NONE, -1, None, None)
+    connection.flush_sync(None)
+    connection.close_sync(None)
+
+
+def main():
+    service = proxytest.start_service()
+    proxy = proxytest.start_proxy("--no-property-cache", "--stats-interval", "1")
+    failures = []
+
+    try:
+        proxytest.set_service_delay(SLOW_MS)
+        fds_before = proxytest.open_fds(proxy.pid)
+        rss_before = proxytest.rss_kib(proxy.pid)
+
+        started = time.monotonic()
+        for _ in range(CALLERS):
+            abandon_calls(proxytest.private_connection())
+
+        expected = CALLERS * CALLS_PER_CALLER
+        cancelled = 0
+        while time.monotonic() - started < SLOW_MS / 3000.0:
+            time.sleep(0.5)
+            cancelled = proxy.last_counter("cancelled") or 0
+            if cancelled >= expected:
+                break
+        elapsed = time.monotonic() - started
+
+        fds_after = proxytest.open_fds(proxy.pid)
+        rss_after = proxytest.rss_kib(proxy.pid)
+        print("cancelled %d of %d forwarded calls in %.1f s" % (cancelled, expected, elapsed))
+        print("proxy fds %d -> %d, RSS %d -> %d KiB" % (fds_before, fds_after, rss_before, rss_after))
+
+        if cancelled < expected:
+            failures.append("only %d of %d abandoned calls were cancelled" % (cancelled, expected))
+        if fds_after > fds_before:
+            failures.append("proxy holds %d more descriptors" % (fds_after - fds_before))
+
+        # The proxy still forwards for callers that stay
+        proxytest.set_service_delay(0)
+        bus = proxytest.session_bus()
+        reply = bus.call_sync(proxytest.PROXY_NAME, proxytest.SERVICE_PATH, "org.freedesktop.DBus.Properties",
+                              "Get", GLib.Variant("(ss)", (proxytest.SERVICE_INTERFACE, "Delay")), None,
+                              Gio.DBusCallFlags.NONE, 5000, None)
+        if reply.unpack()[0] != 0:
+            failures.append("unexpected Delay read through the proxy: %r" % (reply.unpack(),))
+    finally:
+        proxy.stop()
+        service.stop()
+
+    for failure in failures:
+        print("FAIL: %s" % failure)
+    if not failures:
+        print("PASS")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
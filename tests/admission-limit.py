@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+# The adaptive in-flight limit shrinks while the source is slow and grows
+# back once it is fast again. The proxy starts with a limit of 16 and a
+# 50 ms latency target. 48 concurrent 200 ms calls must cut the limit.
+# 400 fast calls afterwards must bring it back to 16.
+#
+#   dbus-run-session -- python3 tests/admission-limit.py [path/to/dbus-proxy]
+
+import sys
+import time
+
+from gi.repository import Gio, GLib
+
+import proxytest
+
+MAX_IN_FLIGHT = 16
+LATENCY_TARGET_MS = 50
+SLOW_CALLS = 48
+SLOW_MS = 200
+FAST_CALLS = 400
+
+
+# Admission counters from a stats line logged after now
+def admission_stats(proxy):
+    count = len([line for line in proxy.output() if "Stats: admission" in line])
+    proxy.wait_for_line("Stats: admission", count + 1, timeout=5)
+    return proxy.last_counter("limit"), proxy.last_counter("limit_decreases")
+
+
+def main():
+    service = proxytest.start_service()
+    proxy = proxytest.start_proxy("--max-in-flight", str(MAX_IN_FLIGHT), "--latency-target", str(LATENCY_TARGET_MS),
+                                  "--stats-interval", "1")
+    failures = []
+
+    try:
+        connection = proxytest.private_connection()
+        limit, decreases = admission_stats(proxy)
+        print("initial limit %d" % limit)
+        if limit != MAX_IN_FLIGHT:
+            failures.append("limit started at %d instead of %d" % (limit, MAX_IN_FLIGHT))
+
+        # Slow replies: the limit is cut
+        replies = []
+        for _ in range(SLOW_CALLS):
+            connection.call(proxytest.PROXY_NAME, proxytest.SERVICE_PATH, proxytest.SERVICE_INTERFACE, "Sleep",
+                            GLib.Variant("(u)", (SLOW_MS,)), None, Gio.DBusCallFlags.NONE, 30000, None,
+                            lambda connection, res, data: replies.append(connection.call_finish(res)), None)
+        proxytest.iterate_until(lambda: len(replies) == SLOW_CALLS, 30)
+        shrunk, decreases = admission_stats(proxy)
+        print("after %d calls of %d ms: limit %d, %d decrease(s)" % (SLOW_CALLS, SLOW_MS, shrunk, decreases))
+        if len(replies) < SLOW_CALLS:
+            failures.append("only %d of %d slow calls were answered" % (len(replies), SLOW_CALLS))
+        if shrunk >= MAX_IN_FLIGHT or decreases == 0:
+            failures.append("slow replies did not cut the limit (limit %d, %d decreases)" % (shrunk, decreases))
+
+        # Fast replies: it grows back to the maximum
+        started = time.monotonic()
+        proxytest.time_calls(connection, FAST_CALLS, "Sleep", GLib.Variant("(u)", (0,)))
+        recovered, _ = admission_stats(proxy)
+        print("after %d fast calls (%.1f s): limit %d" % (FAST_CALLS, time.monotonic() - started, recovered))
+        if recovered != MAX_IN_FLIGHT:
+            failures.append("limit recovered only to %d of %d" % (recovered, MAX_IN_FLIGHT))
+    finally:
+        proxy.stop()
+        service.stop()
+
+    for failure in failures:
+        print("FAIL: %s" % failure)
+    if not failures:
+        print("PASS")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+# The circuit breaker opens when the source is slow, fails calls at once
+# while open, and probes the source after its cooldown. The proxy opens it
+# when the mean latency of 5 calls exceeds 50 ms; it probes after 1 s, with
+# 2 probes. Five 100 ms calls must open it, and the next call must be
+# rejected. A slow probe must reopen it. Of three fast calls after the
+# next cooldown, two are probes and the third is rejected; once the probes
+# succeed, the breaker closes and calls are forwarded again.
+#
+#   dbus-run-session -- python3 tests/circuit-breaker.py [path/to/dbus-proxy]
+
+import sys
+import time
+
+from gi.repository import Gio, GLib
+
+import proxytest
+
+LATENCY_MS = 50
+MIN_CALLS = 5
+COOLDOWN_MS = 1000
+PROBES = 2
+SLOW_MS = 100
+OPEN_ERROR = proxytest.PROXY_NAME + ".Error.CircuitOpen"
+
+
+def call_sleep(connection, ms):
+    try:
+        return connection.call_sync(proxytest.PROXY_NAME, proxytest.SERVICE_PATH, proxytest.SERVICE_INTERFACE,
+                                    "Sleep", GLib.Variant("(u)", (ms,)), GLib.VariantType.new("(u)"),
+                                    Gio.DBusCallFlags.NONE, 5000, None).unpack()[0]
+    except GLib.Error as error:
+        return error
+
+
+def rejected(reply):
+    return isinstance(reply, GLib.Error) and proxytest.error_name(reply) == OPEN_ERROR
+
+
+def on_probe_reply(connection, res, replies):
+    try:
+        replies.append(connection.call_finish(res).unpack()[0])
+    except GLib.Error as error:
+        replies.append(error)
+
+
+def main():
+    service = proxytest.start_service()
+    proxy = proxytest.start_proxy("--breaker-latency", str(LATENCY_MS), "--breaker-min-calls", str(MIN_CALLS),
+                                  "--breaker-window", "10000", "--breaker-cooldown", str(COOLDOWN_MS),
+                                  "--breaker-probes", str(PROBES))
+    failures = []
+
+    try:
+        connection = proxytest.private_connection()
+
+        # Slow calls open the breaker
+        for _ in range(MIN_CALLS):
+            reply = call_sleep(connection, SLOW_MS)
+            if reply != SLOW_MS:
+                failures.append("slow call before the breaker opened failed: %r" % (reply,))
+        started = time.monotonic()
+        reply = call_sleep(connection, 0)
+        elapsed = time.monotonic() - started
+        print("open: call %s in %.1f ms" % ("rejected" if rejected(reply) else "forwarded", elapsed * 1000))
+        if not rejected(reply):
+            failures.append("breaker did not open after %d calls of %d ms: %r" % (MIN_CALLS, SLOW_MS, reply))
+
+        # A slow probe reopens it
+        time.sleep(COOLDOWN_MS / 1000.0 + 0.1)
+        reply = call_sleep(connection, SLOW_MS)
+        if reply != SLOW_MS:
+            failures.append("probe call was not forwarded: %r" % (reply,))
+        if not rejected(call_sleep(connection, 0)):
+            failures.append("breaker did not reopen after a slow probe")
+
+        # Fast probes close it; calls beyond the probes are rejected meanwhile
+        time.sleep(COOLDOWN_MS / 1000.0 + 0.1)
+        replies = []
+        for _ in range(PROBES + 1):
+            connection.call(proxytest.PROXY_NAME, proxytest.SERVICE_PATH, proxytest.SERVICE_INTERFACE, "Sleep",
+                            GLib.Variant("(u)", (10,)), GLib.VariantType.new("(u)"), Gio.DBusCallFlags.NONE,
+                            5000, None, on_probe_reply, replies)
+        proxytest.iterate_until(lambda: len(replies) == PROBES + 1)
+        probed = [reply for reply in replies if reply == 10]
+        turned_away = [reply for reply in replies if rejected(reply)]
+        print("half-open: %d probe(s) forwarded, %d call(s) rejected" % (len(probed), len(turned_away)))
+        if len(probed) != PROBES or len(turned_away) != 1:
+            failures.append("expected %d probes and 1 rejected call while half-open, got %r" % (PROBES, replies))
+        reply = call_sleep(connection, 0)
+        if reply != 0:
+            failures.append("breaker did not close after %d successful probes: %r" % (PROBES, reply))
+    finally:
+        proxy.stop()
+        service.stop()
+
+    transitions = [line.split("Circuit breaker ", 1)[1].split(":")[0] for line in proxy.output()
+                   if "Circuit breaker " in line and "->" in line]
+    print("transitions: %s" % ", ".join(transitions))
+    expected = ["closed -> open", "open -> half-open", "half-open -> open", "open -> half-open",
+                "half-open -> closed"]
+    if transitions != expected:
+        failures.append("breaker went %s, expected %s" % (transitions, expected))
+    if proxy.last_counter("trips") != 2:
+        failures.append("proxy counted %s trips, expected 2" % proxy.last_counter("trips"))
+
+    for failure in failures:
+        print("FAIL: %s" % failure)
+    if not failures:
+        print("PASS")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
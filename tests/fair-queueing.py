@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+# Calls waiting for an in-flight slot are shared fairly between callers and
+# priority classes. The proxy has a limit of one call in flight. Each run
+# checks the order in which the replies arrive.
+#
+# - One client floods the queue with 100 calls, and a second client then
+#   sends 20. Deficit round robin must answer the second client after a
+#   few rounds, not behind the whole flood.
+# - One client sends 60 normal calls followed by 10 background ones. With
+#   --priority-starvation 4, the background calls must be served between
+#   the normal ones. With 0 (strict priority), they must all come last.
+#
+#   dbus-run-session -- python3 tests/fair-queueing.py [path/to/dbus-proxy]
+
+import sys
+
+from gi.repository import Gio, GLib
+
+import proxytest
+
+CALL_MS = 20
+FLOOD = 100
+LATE = 20
+NORMAL = 60
+BACKGROUND = 10
+
+
+# Send count calls of method; their tag is appended to order as each reply arrives
+def send_calls(connection, count, method, parameters, tag, order):
+    def on_reply(connection, res, data):
+        try:
+            connection.call_finish(res)
+            order.append(tag)
+        except GLib.Error as error:
+            order.append(error)
+
+    for _ in range(count):
+        connection.call(proxytest.PROXY_NAME, proxytest.SERVICE_PATH, proxytest.SERVICE_INTERFACE, method,
+                        parameters, None, Gio.DBusCallFlags.NONE, 30000, None, on_reply, None)
+
+
+# Replies tagged other that arrived before the last one tagged tag
+def answered_before_last(order, tag, other):
+    last = max(i for i, t in enumerate(order) if t == tag)
+    return order[:last].count(other)
+
+
+def fairness(failures):
+    proxy = proxytest.start_proxy("--max-in-flight", "1")
+    try:
+        flooder = proxytest.private_connection()
+        late = proxytest.private_connection()
+        order = []
+        send_calls(flooder, FLOOD, "Sleep", GLib.Variant("(u)", (CALL_MS,)), "flood", order)
+        proxytest.iterate_until(lambda: False, 0.1)
+        send_calls(late, LATE, "Sleep", GLib.Variant("(u)", (CALL_MS,)), "late", order)
+        proxytest.iterate_until(lambda: order.count("late") == LATE, 30)
+    finally:
+        proxy.stop()
+
+    errors = [reply for reply in order if isinstance(reply, GLib.Error)]
+    for error in errors:
+        failures.append("call failed: %s" % error.message)
+    if order.count("late") < LATE:
+        failures.append("only %d of the late client's %d calls were answered" % (order.count("late"), LATE))
+        return
+    flooded = answered_before_last(order, "late", "flood")
+    print("late client done after %d of the flooding client's %d calls" % (flooded, FLOOD))
+    if flooded > FLOOD // 2:
+        failures.append("the late client waited behind %d flooding calls" % flooded)
+
+
+def starvation(failures, starvation_limit):
+    proxy = proxytest.start_proxy("--max-in-flight", "1", "--priority", "member:Echo=background",
+                                  "--priority-starvation", str(starvation_limit))
+    try:
+        connection = proxytest.private_connection()
+        order = []
+        send_calls(connection, NORMAL, "Sleep", GLib.Variant("(u)", (CALL_MS,)), "normal", order)
+        send_calls(connection, BACKGROUND, "Echo", proxytest.byte_array_parameters(16), "background", order)
+        proxytest.iterate_until(lambda: len(order) == NORMAL + BACKGROUND, 30)
+    finally:
+        proxy.stop()
+
+    errors = [reply for reply in order if isinstance(reply, GLib.Error)]
+    for error in errors:
+        failures.append("call failed: %s" % error.message)
+    if len(order) < NORMAL + BACKGROUND:
+        failures.append("only %d of %d calls were answered" % (len(order), NORMAL + BACKGROUND))
+        return
+    served = answered_before_last(order, "background", "normal")
+    print("--priority-starvation %d: background calls done after %d of %d normal calls" % (
+        starvation_limit, served, NORMAL))
+    if starvation_limit > 0 and served > (starvation_limit + 1) * BACKGROUND:
+        failures.append("background calls waited behind %d normal calls with --priority-starvation %d" % (
+            served, starvation_limit))
+    if starvation_limit == 0 and order.index("background") < NORMAL - 1:
+        failures.append("a background call overtook %d normal calls under strict priority" % (
+            NORMAL - 1 - order.index("background")))
+
+
+def main():
+    service = proxytest.start_service()
+    failures = []
+
+    try:
+        fairness(failures)
+        starvation(failures, 4)
+        starvation(failures, 0)
+    finally:
+        service.stop()
+
+    for failure in failures:
+        print("FAIL: %s" % failure)
+    if not failures:
+        print("PASS")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
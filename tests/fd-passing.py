@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+# Unix fds pass through the proxy in calls, replies and signals without the
+# proxy keeping any of them. A 100 MB memfd goes to the source in a call
+# argument, comes back in a reply and is announced in a signal, for a number
+# of rounds; the data must arrive intact each time, and the proxy must end
+# with the descriptors it started with (counted in /proc/PID/fd).
+#
+#   dbus-run-session -- python3 tests/fd-passing.py [path/to/dbus-proxy]
+
+import os
+import sys
+import threading
+import time
+
+from gi.repository import Gio, GLib
+
+import proxytest
+
+BLOB_SIZE = 100 * 1024 * 1024
+ROUNDS = 10
+
+
+# Signals carrying fds arrive on the GDBus worker thread; only a filter sees
+# the message, and with it the fd list
+class BlobSignals:
+    def __init__(self, connection, sender):
+        self.received = []
+        self.condition = threading.Condition()
+        connection.signal_subscribe(sender, proxytest.SERVICE_INTERFACE, "BlobReady", proxytest.SERVICE_PATH,
+                                    None, Gio.DBusSignalFlags.NONE, lambda *args: None)
+        connection.add_filter(self._filter)
+
+    def _filter(self, connection, message, incoming):
+        if (incoming and message.get_message_type() == Gio.DBusMessageType.SIGNAL and
+                message.get_member() == "BlobReady" and message.get_unix_fd_list()):
+            fd = message.get_unix_fd_list().get(message.get_body().unpack()[0])
+            with self.condition:
+                self.received.append((fd, message.get_body().unpack()[1]))
+                self.condition.notify_all()
+        return message
+
+    def wait(self, timeout=30.0):
+        with self.condition:
+            if not self.condition.wait_for(lambda: self.received, timeout):
+                raise RuntimeError("no BlobReady signal through the proxy")
+            return self.received.pop(0)
+
+
+def call(connection, method, parameters, fd_list=None):
+    return connection.call_with_unix_fd_list_sync(proxytest.PROXY_NAME, proxytest.SERVICE_PATH,
+                                                  proxytest.SERVICE_INTERFACE, method, parameters, None,
+                                                  Gio.DBusCallFlags.NONE, 60000, fd_list, None)
+
+
+def main():
+    service = proxytest.start_service()
+    proxy = proxytest.start_proxy()
+    expected = proxytest.blob_sha256(BLOB_SIZE)
+    failures = []
+    timings = {"call": 0.0, "reply": 0.0, "signal": 0.0}
+
+    try:
+        bus = proxytest.private_connection()
+        owner = bus.call_sync("org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus",
+                              "GetNameOwner", GLib.Variant("(s)", (proxytest.PROXY_NAME,)), None,
+                              Gio.DBusCallFlags.NONE, -1, None).unpack()[0]
+        signals = BlobSignals(bus, owner)
+        fds_before = proxytest.open_fds(proxy.pid)
+
+        for _ in range(ROUNDS):
+            # Call argument: the source reads the blob the client wrote
+            fd = proxytest.blob_memfd(BLOB_SIZE)
+            started = time.monotonic()
+            reply, _ = call(bus, "Checksum", GLib.Variant("(h)", (0,)), Gio.UnixFDList.new_from_array([fd]))
+            timings["call"] += time.monotonic() - started
+            if reply.unpack() != (BLOB_SIZE, expected):
+                failures.append("Checksum through the proxy returned %r" % (reply.unpack(),))
+
+            # Reply: the client reads the blob the source wrote
+            started = time.monotonic()
+            reply, out_fds = call(bus, "OpenBlob", GLib.Variant("(t)", (BLOB_SIZE,)))
+            fd = out_fds.get(reply.unpack()[0])
+            checksum = proxytest.file_checksum(fd)
+            timings["reply"] += time.monotonic() - started
+            os.close(fd)
+            if checksum != (BLOB_SIZE, expected):
+                failures.append("OpenBlob through the proxy returned a blob of %d bytes" % checksum[0])
+
+            # Signal: the source announces a blob to the proxy's clients
+            started = time.monotonic()
+            call(bus, "EmitBlob", GLib.Variant("(t)", (BLOB_SIZE,)))
+            fd, size = signals.wait()
+            checksum = proxytest.file_checksum(fd)
+            timings["signal"] += time.monotonic() - started
+            os.close(fd)
+            if checksum != (BLOB_SIZE, expected) or size != BLOB_SIZE:
+                failures.append("BlobReady through the proxy carried %d of %d bytes" % (checksum[0], size))
+
+        # Replies and signals leave the proxy asynchronously
+        time.sleep(1)
+        fds_after = proxytest.open_fds(proxy.pid)
+
+        megabytes = BLOB_SIZE * ROUNDS / (1024 * 1024)
+        for path, seconds in timings.items():
+            print("%-6s %d x %d MB in %.2f s (%.0f MB/s)" % (path, ROUNDS, BLOB_SIZE >> 20, seconds,
+                                                           megabytes / seconds if seconds else 0))
+        print("proxy fds %d -> %d" % (fds_before, fds_after))
+        if fds_after != fds_before:
+            failures.append("proxy fd count changed by %+d" % (fds_after - fds_before))
+    finally:
+        proxy.stop()
+        service.stop()
+
+    for failure in failures:
+        print("FAIL: %s" % failure)
+    if not failures:
+        print("PASS")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
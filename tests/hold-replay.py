@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+# Calls made while the source is down are held and replayed once it is
+# back. The test service is stopped and 10 calls are sent through the
+# proxy. None may be answered before the service is restarted, and all must
+# succeed after it. The replay must also wait for the proxy to resync with
+# the restarted service. A second proxy with a 3-call, 300 ms hold queue
+# must fail the calls that do not fit at once and the rest on expiry, both
+# with ServiceUnknown.
+#
+#   dbus-run-session -- python3 tests/hold-replay.py [path/to/dbus-proxy]
+
+import sys
+import time
+
+from gi.repository import Gio, GLib
+
+import proxytest
+
+HELD = 10
+HOLD_MESSAGES = 3
+HOLD_TIMEOUT_MS = 300
+OVERFLOW = 2
+
+
+# Send count Sleep(0) calls; their replies or errors, with the time each
+# took, land in results
+def send_calls(connection, count, results):
+    def on_reply(connection, res, started):
+        try:
+            reply = connection.call_finish(res).unpack()[0]
+        except GLib.Error as error:
+            reply = error
+        results.append((reply, time.monotonic() - started))
+
+    for _ in range(count):
+        connection.call(proxytest.PROXY_NAME, proxytest.SERVICE_PATH, proxytest.SERVICE_INTERFACE, "Sleep",
+                        GLib.Variant("(u)", (0,)), GLib.VariantType.new("(u)"), Gio.DBusCallFlags.NONE, 30000,
+                        None, on_reply, time.monotonic())
+
+
+def main():
+    service = proxytest.start_service()
+    failures = []
+
+    try:
+        proxy = proxytest.start_proxy("--hold-messages", "100", "--hold-timeout", "10000", "--stats-interval", "1")
+        try:
+            connection = proxytest.private_connection()
+            service.stop()
+            proxy.wait_for_line("lost its owner")
+
+            results = []
+            send_calls(connection, HELD, results)
+            proxytest.iterate_until(lambda: False, 0.5)
+            if results:
+                failures.append("%d call(s) answered while the source was down" % len(results))
+
+            service = proxytest.start_service()
+            proxytest.iterate_until(lambda: len(results) == HELD)
+            errors = [reply for reply, _ in results if isinstance(reply, GLib.Error)]
+            print("%d held call(s) answered after the restart, %d failed" % (len(results), len(errors)))
+            if len(results) < HELD:
+                failures.append("only %d of %d held calls were answered" % (len(results), HELD))
+            for error in errors:
+                failures.append("held call failed: %s" % error.message)
+
+            output = proxy.output()
+            resynced = [i for i, line in enumerate(output) if "Resynchronized with restarted source" in line]
+            replayed = [i for i, line in enumerate(output) if "replaying %d held call(s)" % HELD in line]
+            if not replayed:
+                failures.append("the proxy did not log the replay")
+            elif not resynced or resynced[0] > replayed[0]:
+                failures.append("held calls were replayed before the resync finished")
+        finally:
+            proxy.stop()
+
+        if proxy.last_counter("replayed") != HELD:
+            failures.append("proxy counted %s replayed call(s), expected %d" % (proxy.last_counter("replayed"), HELD))
+
+        # A small hold queue: the overflow fails at once, the rest on expiry
+        proxy = proxytest.start_proxy("--hold-messages", str(HOLD_MESSAGES), "--hold-timeout", str(HOLD_TIMEOUT_MS))
+        try:
+            connection = proxytest.private_connection()
+            service.stop()
+            proxy.wait_for_line("lost its owner")
+
+            results = []
+            send_calls(connection, HOLD_MESSAGES + OVERFLOW, results)
+            proxytest.iterate_until(lambda: len(results) == HOLD_MESSAGES + OVERFLOW)
+
+            for reply, elapsed in results:
+                if not isinstance(reply, GLib.Error):
+                    failures.append("call answered while the source was down: %r" % (reply,))
+                elif proxytest.error_name(reply) != "org.freedesktop.DBus.Error.ServiceUnknown":
+                    failures.append("unexpected error for a held call: %s" % proxytest.error_name(reply))
+            rejected = [elapsed for _, elapsed in results if elapsed < HOLD_TIMEOUT_MS / 1000.0]
+            expired = [elapsed for _, elapsed in results if elapsed >= HOLD_TIMEOUT_MS / 1000.0]
+            print("hold queue of %d: %d call(s) rejected at once, %d expired after %.0f-%.0f ms" % (
+                HOLD_MESSAGES, len(rejected), len(expired), min(expired, default=0) * 1000,
+                max(expired, default=0) * 1000))
+            if len(rejected) != OVERFLOW or len(expired) != HOLD_MESSAGES:
+                failures.append("expected %d rejected and %d expired calls, got %d and %d" % (
+                    OVERFLOW, HOLD_MESSAGES, len(rejected), len(expired)))
+            if expired and max(expired) > HOLD_TIMEOUT_MS / 1000.0 + 2:
+                failures.append("held calls expired only after %.1f s" % max(expired))
+        finally:
+            proxy.stop()
+    finally:
+        service.stop()
+
+    for failure in failures:
+        print("FAIL: %s" % failure)
+    if not failures:
+        print("PASS")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+# Objects announced by the source's ObjectManager must be callable through
+# the proxy as soon as target clients see their InterfacesAdded. The test
+# service adds 20 widgets, whose interface the proxy has not seen before,
+# and the client calls each one from its InterfacesAdded handler.
+#
+#   dbus-run-session -- python3 tests/interfaces-added.py [path/to/dbus-proxy]
+
+import sys
+
+from gi.repository import Gio, GLib
+
+import proxytest
+
+WIDGETS = 20
+
+
+def main():
+    service = proxytest.start_service("--object-manager")
+    proxy = proxytest.start_proxy()
+    failures = []
+
+    try:
+        connection = proxytest.private_connection()
+        announced = []
+        replies = {}
+
+        def on_ping(connection, res, path):
+            try:
+                replies[path] = connection.call_finish(res).unpack()[0]
+            except GLib.Error as error:
+                replies[path] = error
+
+        def on_interfaces_added(connection, sender, path, interface, signal, parameters):
+            widget = parameters.unpack()[0]
+            announced.append(widget)
+            connection.call(proxytest.PROXY_NAME, widget, proxytest.SERVICE_INTERFACE + ".Widget", "Ping",
+                            None, GLib.VariantType.new("(s)"), Gio.DBusCallFlags.NONE, 5000, None,
+                            on_ping, widget)
+
+        # Only the proxy's copy; the service's own signal is on the bus too
+        connection.signal_subscribe(proxytest.PROXY_NAME, "org.freedesktop.DBus.ObjectManager",
+                                    "InterfacesAdded", proxytest.SERVICE_PATH, None, Gio.DBusSignalFlags.NONE,
+                                    on_interfaces_added)
+
+        service_bus = proxytest.session_bus()
+        for _ in range(WIDGETS):
+            service_bus.call_sync(proxytest.SERVICE_NAME, proxytest.SERVICE_PATH,
+                                  proxytest.SERVICE_INTERFACE + ".Widgets", "AddWidget", None, None,
+                                  Gio.DBusCallFlags.NONE, -1, None)
+
+        proxytest.iterate_until(lambda: len(replies) == WIDGETS)
+
+        print("%d InterfacesAdded forwarded, %d calls answered" % (len(announced), len(replies)))
+        if len(announced) < WIDGETS:
+            failures.append("only %d of %d InterfacesAdded were forwarded" % (len(announced), WIDGETS))
+        for widget, reply in sorted(replies.items()):
+            if isinstance(reply, GLib.Error):
+                failures.append("calling %s right after InterfacesAdded failed: %s" % (widget, reply.message))
+            elif reply != widget.rsplit("/", 1)[1]:
+                failures.append("unexpected reply from %s: %r" % (widget, reply))
+        if announced != sorted(announced, key=lambda path: int(path.rsplit("widget", 1)[1])):
+            failures.append("InterfacesAdded arrived out of order: %s" % announced)
+    finally:
+        proxy.stop()
+        service.stop()
+
+    for failure in failures:
+        print("FAIL: %s" % failure)
+    if not failures:
+        print("PASS")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+# Call latency percentiles come from the proxy's histogram and are measured
+# from each call's arrival, so time spent waiting for an in-flight slot
+# counts. With one call in flight, the test sends 90 sequential 5 ms calls
+# and then 10 concurrent 100 ms calls, which are served one after another.
+# The proxy's shutdown stats must report 100 calls, a p50 near 5 ms and a
+# p99 near the 900 ms the second-to-last queued call took.
+#
+#   dbus-run-session -- python3 tests/latency-histogram.py [path/to/dbus-proxy]
+
+import re
+import sys
+
+from gi.repository import Gio, GLib
+
+import proxytest
+
+FAST = 90
+FAST_MS = 5
+QUEUED = 10
+QUEUED_MS = 100
+
+
+def main():
+    service = proxytest.start_service()
+    proxy = proxytest.start_proxy("--max-in-flight", "1")
+    failures = []
+
+    try:
+        connection = proxytest.private_connection()
+        proxytest.time_calls(connection, FAST, "Sleep", GLib.Variant("(u)", (FAST_MS,)))
+
+        replies = []
+        for _ in range(QUEUED):
+            connection.call(proxytest.PROXY_NAME, proxytest.SERVICE_PATH, proxytest.SERVICE_INTERFACE, "Sleep",
+                            GLib.Variant("(u)", (QUEUED_MS,)), None, Gio.DBusCallFlags.NONE, 30000, None,
+                            lambda connection, res, data: replies.append(connection.call_finish(res)), None)
+        proxytest.iterate_until(lambda: len(replies) == QUEUED, 30)
+    finally:
+        proxy.stop()
+        service.stop()
+
+    line = next((line for line in proxy.output() if "Stats: priority normal" in line), None)
+    match = line and re.search(r"calls=(\d+) p50_us=(\d+) p90_us=(\d+) p99_us=(\d+)", line)
+    if not match:
+        failures.append("no call latency stats in the proxy output")
+    else:
+        calls, p50, p90, p99 = (int(value) for value in match.groups())
+        print("calls=%d p50=%.1f ms p90=%.1f ms p99=%.1f ms" % (calls, p50 / 1000.0, p90 / 1000.0, p99 / 1000.0))
+        if calls != FAST + QUEUED:
+            failures.append("histogram holds %d calls, expected %d" % (calls, FAST + QUEUED))
+        if not FAST_MS * 1000 <= p50 <= FAST_MS * 4000:
+            failures.append("p50 of %d us is not near %d ms" % (p50, FAST_MS))
+        if not p50 <= p90 <= p99:
+            failures.append("percentiles out of order: %d, %d, %d us" % (p50, p90, p99))
+        # Percentiles are bucket upper bounds, at most 25% above the sample
+        expected = (QUEUED - 1) * QUEUED_MS * 1000
+        if not expected * 0.9 <= p99 <= expected * 1.5:
+            failures.append("p99 of %d us does not include the admission wait (expected about %d us)" % (
+                p99, expected))
+
+    for failure in failures:
+        print("FAIL: %s" % failure)
+    if not failures:
+        print("PASS")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,231 @@
+# Helpers shared by the test and benchmark scripts: start the slow test
+# service and a dbus-proxy in front of it on the session bus, and look at
+# the proxy process from /proc. Run the scripts under dbus-run-session so
+# they get a private bus, e.g.
+#
+#   dbus-run-session -- python3 tests/abandoned-calls.py ./dbus-proxy
+
+import hashlib
+import os
+import re
+import subprocess
+import sys
+import threading
+import time
+
+from gi.repository import Gio, GLib
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+SERVICE_NAME = "org.example.SlowService"
+SERVICE_PATH = "/org/example/SlowService"
+SERVICE_INTERFACE = "org.example.SlowService"
+PROXY_NAME = "org.example.SlowProxy"
+
+
+def proxy_binary():
+    if len(sys.argv) > 1:
+        return sys.argv[1]
+    return os.path.join(HERE, "..", "dbus-proxy")
+
+
+def session_bus():
+    return Gio.bus_get_sync(Gio.BusType.SESSION, None)
+
+
+# A connection of its own, so closing it makes the bus report the caller gone
+def private_connection():
+    address = Gio.dbus_address_get_for_bus_sync(Gio.BusType.SESSION, None)
+    flags = Gio.DBusConnectionFlags.AUTHENTICATION_CLIENT | Gio.DBusConnectionFlags.MESSAGE_BUS_CONNECTION
+    return Gio.DBusConnection.new_for_address_sync(address, flags, None, None)
+
+
+# Wait until name is owned, by process pid if given (a proxy started right
+# after another one must not be mistaken for it)
+def wait_for_name(name, pid=None, timeout=60.0):
+    bus = session_bus()
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        try:
+            owner_pid = bus.call_sync("org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus",
+                                      "GetConnectionUnixProcessID", GLib.Variant("(s)", (name,)), None,
+                                      Gio.DBusCallFlags.NONE, -1, None).unpack()[0]
+            if pid is None or owner_pid == pid:
+                return
+        except GLib.Error:
+            pass
+        time.sleep(0.01)
+    raise RuntimeError("%s did not appear on the bus" % name)
+
+
+def set_service_delay(ms):
+    session_bus().call_sync(SERVICE_NAME, SERVICE_PATH, "org.freedesktop.DBus.Properties", "Set",
+                            GLib.Variant("(ssv)", (SERVICE_INTERFACE, "Delay", GLib.Variant("u", ms))),
+                            None, Gio.DBusCallFlags.NONE, -1, None)
+
+
+class Process:
+    """A child process whose stdout is collected line by line."""
+
+    def __init__(self, argv):
+        self.popen = subprocess.Popen(argv, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+        self.lines = []
+        self.lock = threading.Lock()
+        self.reader = threading.Thread(target=self._read, daemon=True)
+        self.reader.start()
+
+    def _read(self):
+        for line in self.popen.stdout:
+            with self.lock:
+                self.lines.append(line.rstrip("\n"))
+
+    @property
+    def pid(self):
+        return self.popen.pid
+
+    def output(self):
+        with self.lock:
+            return list(self.lines)
+
+    # Last value of "key=N" in the output, e.g. from a stats line
+    def last_counter(self, key):
+        pattern = re.compile(r"\b%s=(\d+)" % re.escape(key))
+        for line in reversed(self.output()):
+            match = pattern.search(line)
+            if match:
+                return int(match.group(1))
+        return None
+
+    # Wait until count lines containing text have been printed; returns the
+    # count-th of them
+    def wait_for_line(self, text, count=1, timeout=10.0):
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            lines = [line for line in self.output() if text in line]
+            if len(lines) >= count:
+                return lines[count - 1]
+            time.sleep(0.05)
+        raise RuntimeError("%r was not printed %d time(s)" % (text, count))
+
+    def stop(self):
+        if self.popen.poll() is None:
+            self.popen.terminate()
+            try:
+                self.popen.wait(timeout=10)
+            except subprocess.TimeoutExpired:
+                self.popen.kill()
+                self.popen.wait()
+        self.reader.join(timeout=5)
+        return self.popen.returncode
+
+
+def start_service(*options):
+    service = Process([sys.executable, os.path.join(HERE, "slow-service.py")] + list(options))
+    wait_for_name(SERVICE_NAME)
+    return service
+
+
+def start_proxy(*options):
+    argv = [proxy_binary(),
+            "--source-bus-type", "session", "--target-bus-type", "session",
+            "--source-bus-name", SERVICE_NAME, "--source-object-path", SERVICE_PATH,
+            "--proxy-bus-name", PROXY_NAME] + list(options)
+    proxy = Process(argv)
+    wait_for_name(PROXY_NAME, proxy.pid)
+    return proxy
+
+
+def open_fds(pid):
+    return len(os.listdir("/proc/%d/fd" % pid))
+
+
+def rss_kib(pid):
+    with open("/proc/%d/status" % pid) as status:
+        for line in status:
+            if line.startswith("VmRSS:"):
+                return int(line.split()[1])
+    return 0
+
+
+# Contents of a test blob: a repeating 1 MiB pattern
+def blob_chunks(size):
+    pattern = bytes(range(256)) * 4096
+    while size > 0:
+        yield pattern[:size]
+        size -= len(pattern)
+
+
+def blob_sha256(size):
+    digest = hashlib.sha256()
+    for chunk in blob_chunks(size):
+        digest.update(chunk)
+    return digest.hexdigest()
+
+
+# A memfd holding a test blob; the caller owns the descriptor
+def blob_memfd(size):
+    fd = os.memfd_create("proxy-test-blob", os.MFD_CLOEXEC)
+    for chunk in blob_chunks(size):
+        os.write(fd, chunk)
+    return fd
+
+
+# Size and SHA-256 of a file, read from the start whatever its offset
+def file_checksum(fd):
+    digest = hashlib.sha256()
+    offset = 0
+    while True:
+        chunk = os.pread(fd, 1 << 20, offset)
+        if not chunk:
+            return offset, digest.hexdigest()
+        digest.update(chunk)
+        offset += len(chunk)
+
+
+def percentile(samples, pct):
+    ordered = sorted(samples)
+    if not ordered:
+        return 0.0
+    return ordered[min(len(ordered) - 1, int(len(ordered) * pct / 100.0))]
+
+
+# One line of latency percentiles, in ms, for a list of durations in seconds
+def report_latency(label, samples):
+    print("%-28s n=%-6d p50=%7.2f p90=%7.2f p99=%7.2f max=%7.2f ms" % (
+        label, len(samples), percentile(samples, 50) * 1000, percentile(samples, 90) * 1000,
+        percentile(samples, 99) * 1000, max(samples, default=0) * 1000))
+
+
+# D-Bus error name of a failed call, e.g. org.freedesktop.DBus.Error.ServiceUnknown
+def error_name(error):
+    return Gio.dbus_error_get_remote_error(error)
+
+
+# Dispatch the default main context until done() holds or timeout (s)
+# passes; returns done()
+def iterate_until(done, timeout=10.0):
+    context = GLib.MainContext.default()
+    deadline = time.monotonic() + timeout
+    while not done() and time.monotonic() < deadline:
+        if not context.iteration(False):
+            time.sleep(0.01)
+    return done()
+
+
+# Durations of count synchronous calls of a method of the test service,
+# through the proxy unless another destination is given
+def time_calls(connection, count, method, parameters, interface=SERVICE_INTERFACE, path=SERVICE_PATH,
+               destination=PROXY_NAME):
+    samples = []
+    for _ in range(count):
+        started = time.monotonic()
+        connection.call_sync(destination, path, interface, method, parameters, None,
+                             Gio.DBusCallFlags.NONE, -1, None)
+        samples.append(time.monotonic() - started)
+    return samples
+
+
+# (ay) parameters of size bytes, built without a Python list per byte
+def byte_array_parameters(size):
+    data = GLib.Variant.new_from_bytes(GLib.VariantType.new("ay"), GLib.Bytes.new(b"\xa5" * size), True)
+    return GLib.Variant.new_tuple(data)
@@ -0,0 +1,219 @@
+#!/usr/bin/env python3
+# Test service for the scripts in this directory. Owns org.example.SlowService
+# on the session bus and exports /org/example/SlowService, whose method
+# replies and property reads take as long as asked, so callers can give up
+# on them while they are in flight. The Blob methods and signal pass large
+# files as unix fds in either direction. With --objects N, N item objects
+# are exported below it as well, 100 per group:
+# /org/example/SlowService/group<G>/item<I>. With --object-manager, it
+# implements org.freedesktop.DBus.ObjectManager instead, and AddWidget
+# exports /org/example/SlowService/widget<N> with an interface that no
+# object has before, announced by InterfacesAdded. With --extra-interface,
+# the service object has one more interface, so restarting the service
+# with or without it changes what the proxy has to mirror.
+
+import os
+import sys
+
+from gi.repository import Gio, GLib
+
+import proxytest
+
+BUS_NAME = "org.example.SlowService"
+OBJECT_PATH = "/org/example/SlowService"
+
+INTROSPECTION = """
+<node>
+  <interface name="org.example.SlowService">
+    <method name="Sleep">
+      <arg name="ms" type="u" direction="in"/>
+      <arg name="slept" type="u" direction="out"/>
+    </method>
+    <method name="Echo">
+      <arg name="data" type="ay" direction="in"/>
+      <arg name="data" type="ay" direction="out"/>
+    </method>
+    <method name="Checksum">
+      <arg name="blob" type="h" direction="in"/>
+      <arg name="size" type="t" direction="out"/>
+      <arg name="sha256" type="s" direction="out"/>
+    </method>
+    <method name="OpenBlob">
+      <arg name="size" type="t" direction="in"/>
+      <arg name="blob" type="h" direction="out"/>
+    </method>
+    <method name="EmitBlob">
+      <arg name="size" type="t" direction="in"/>
+    </method>
+    <signal name="BlobReady">
+      <arg name="blob" type="h"/>
+      <arg name="size" type="t"/>
+    </signal>
+    <property name="SlowValue" type="s" access="readwrite"/>
+    <property name="Delay" type="u" access="readwrite"/>
+  </interface>
+  <interface name="org.example.SlowService.Item">
+    <property name="Index" type="u" access="read"/>
+  </interface>
+</node>
+"""
+
+OBJECT_MANAGER_INTROSPECTION = """
+<node>
+  <interface name="org.freedesktop.DBus.ObjectManager">
+    <method name="GetManagedObjects">
+      <arg name="objects" type="a{oa{sa{sv}}}" direction="out"/>
+    </method>
+    <signal name="InterfacesAdded">
+      <arg name="object" type="o"/>
+      <arg name="interfaces" type="a{sa{sv}}"/>
+    </signal>
+    <signal name="InterfacesRemoved">
+      <arg name="object" type="o"/>
+      <arg name="interfaces" type="as"/>
+    </signal>
+  </interface>
+  <interface name="org.example.SlowService.Widgets">
+    <method name="AddWidget">
+      <arg name="path" type="o" direction="out"/>
+    </method>
+  </interface>
+  <interface name="org.example.SlowService.Widget">
+    <method name="Ping">
+      <arg name="name" type="s" direction="out"/>
+    </method>
+    <property name="Name" type="s" access="read"/>
+  </interface>
+</node>
+"""
+
+EXTRA_INTROSPECTION = """
+<node>
+  <interface name="org.example.SlowService.Extra">
+    <method name="Hello">
+      <arg name="greeting" type="s" direction="out"/>
+    </method>
+  </interface>
+</node>
+"""
+
+# Delay (ms) applies to SlowValue reads and writes and to GetAll; tests set it
+# once the proxy has started, so startup is not slowed down
+state = {"SlowValue": GLib.Variant("s", "initial"), "Delay": GLib.Variant("u", 0)}
+
+
+def reply_later(invocation, ms, value):
+    def reply():
+        invocation.return_value(value)
+        return GLib.SOURCE_REMOVE
+
+    GLib.timeout_add(ms, reply)
+
+
+# Properties calls come here too: with no get/set handlers, GDBus leaves
+# them to method_call, which lets their replies be delayed like any method
+def on_method_call(connection, sender, path, interface, method, parameters, invocation):
+    delay = state["Delay"].get_uint32()
+
+    if interface == "org.freedesktop.DBus.Properties":
+        if method == "Get":
+            _, name = parameters.unpack()
+            reply_later(invocation, delay if name == "SlowValue" else 0, GLib.Variant("(v)", (state[name],)))
+        elif method == "GetAll":
+            reply_later(invocation, delay, GLib.Variant("(a{sv})", (state,)))
+        elif method == "Set":
+            _, name, value = parameters.unpack()
+            state[name] = GLib.Variant("u" if name == "Delay" else "s", value)
+            reply_later(invocation, delay if name == "SlowValue" else 0, None)
+        return
+
+    if method == "Sleep":
+        (ms,) = parameters.unpack()
+        reply_later(invocation, ms, GLib.Variant("(u)", (ms,)))
+    elif method == "Echo":
+        invocation.return_value(parameters)
+    elif method == "Checksum":
+        fd_list = invocation.get_message().get_unix_fd_list()
+        fd = fd_list.get(parameters.unpack()[0])
+        size, digest = proxytest.file_checksum(fd)
+        os.close(fd)
+        invocation.return_value(GLib.Variant("(ts)", (size, digest)))
+    elif method == "OpenBlob":
+        fd = proxytest.blob_memfd(parameters.unpack()[0])
+        invocation.return_value_with_unix_fd_list(GLib.Variant("(h)", (0,)), Gio.UnixFDList.new_from_array([fd]))
+    elif method == "EmitBlob":
+        (size,) = parameters.unpack()
+        fd = proxytest.blob_memfd(size)
+        message = Gio.DBusMessage.new_signal(OBJECT_PATH, interface, "BlobReady")
+        message.set_body(GLib.Variant("(ht)", (0, size)))
+        message.set_unix_fd_list(Gio.UnixFDList.new_from_array([fd]))
+        connection.send_message(message, Gio.DBusSendMessageFlags.NONE)
+        invocation.return_value(None)
+
+
+def on_extra_call(connection, sender, path, interface, method, parameters, invocation):
+    invocation.return_value(GLib.Variant("(s)", ("hello",)))
+
+
+def on_item_get_property(connection, sender, path, interface, name):
+    return GLib.Variant("u", int(path.rsplit("item", 1)[1]))
+
+
+widgets = {}
+
+
+def widget_properties(path):
+    return {"Name": GLib.Variant("s", path.rsplit("/", 1)[1])}
+
+
+def on_widget_call(connection, sender, path, interface, method, parameters, invocation):
+    invocation.return_value(GLib.Variant("(s)", (widget_properties(path)["Name"].unpack(),)))
+
+
+def on_widget_get_property(connection, sender, path, interface, name):
+    return widget_properties(path)[name]
+
+
+# ObjectManager and AddWidget, registered on the service object with --object-manager
+def on_object_manager_call(connection, sender, path, interface, method, parameters, invocation, node):
+    if method == "GetManagedObjects":
+        objects = {widget: {node.interfaces[2].name: widget_properties(widget)} for widget in widgets}
+        invocation.return_value(GLib.Variant("(a{oa{sa{sv}}})", (objects,)))
+    elif method == "AddWidget":
+        path = "%s/widget%d" % (OBJECT_PATH, len(widgets))
+        widgets[path] = connection.register_object(path, node.interfaces[2], on_widget_call,
+                                                   on_widget_get_property, None)
+        connection.emit_signal(None, OBJECT_PATH, "org.freedesktop.DBus.ObjectManager", "InterfacesAdded",
+                               GLib.Variant("(oa{sa{sv}})",
+                                            (path, {node.interfaces[2].name: widget_properties(path)})))
+        invocation.return_value(GLib.Variant("(o)", (path,)))
+
+
+def main():
+    objects = int(sys.argv[sys.argv.index("--objects") + 1]) if "--objects" in sys.argv else 0
+    node = Gio.DBusNodeInfo.new_for_xml(INTROSPECTION)
+    connection = Gio.bus_get_sync(Gio.BusType.SESSION, None)
+    connection.register_object(OBJECT_PATH, node.interfaces[0], on_method_call, None, None)
+    for i in range(objects):
+        path = "%s/group%d/item%d" % (OBJECT_PATH, i // 100, i)
+        connection.register_object(path, node.interfaces[1], None, on_item_get_property, None)
+    if "--extra-interface" in sys.argv:
+        extra = Gio.DBusNodeInfo.new_for_xml(EXTRA_INTROSPECTION)
+        connection.register_object(OBJECT_PATH, extra.interfaces[0], on_extra_call, None, None)
+    if "--object-manager" in sys.argv:
+        manager = Gio.DBusNodeInfo.new_for_xml(OBJECT_MANAGER_INTROSPECTION)
+        for iface in manager.interfaces[:2]:
+            connection.register_object(OBJECT_PATH, iface,
+                                       lambda *args: on_object_manager_call(*args, node=manager), None, None)
+
+    loop = GLib.MainLoop()
+    Gio.bus_own_name_on_connection(connection, BUS_NAME, Gio.BusNameOwnerFlags.NONE,
+                                   lambda *args: print("ready", flush=True),
+                                   lambda *args: loop.quit())
+    GLib.unix_signal_add(GLib.PRIORITY_DEFAULT, 15, loop.quit)
+    loop.run()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
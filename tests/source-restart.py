@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+# A restarted source is resynchronized by diff: only interfaces whose
+# introspection data changed are touched. The test service is restarted
+# with one more interface on its object, then without it again. Each resync
+# must report exactly that interface as changed. The proxy must serve the
+# new interface only while the service has it, and it must keep forwarding
+# the interface that never changed.
+#
+#   dbus-run-session -- python3 tests/source-restart.py [path/to/dbus-proxy]
+
+import re
+import sys
+
+from gi.repository import Gio, GLib
+
+import proxytest
+
+EXTRA_INTERFACE = proxytest.SERVICE_INTERFACE + ".Extra"
+
+
+def proxy_interfaces(connection):
+    xml = connection.call_sync(proxytest.PROXY_NAME, proxytest.SERVICE_PATH, "org.freedesktop.DBus.Introspectable",
+                               "Introspect", None, GLib.VariantType.new("(s)"), Gio.DBusCallFlags.NONE, 5000,
+                               None).unpack()[0]
+    return [iface.name for iface in Gio.DBusNodeInfo.new_for_xml(xml).interfaces]
+
+
+def call_hello(connection):
+    try:
+        return connection.call_sync(proxytest.PROXY_NAME, proxytest.SERVICE_PATH, EXTRA_INTERFACE, "Hello", None,
+                                    GLib.VariantType.new("(s)"), Gio.DBusCallFlags.NONE, 5000, None).unpack()[0]
+    except GLib.Error as error:
+        return error
+
+
+def call_sleep(connection):
+    return connection.call_sync(proxytest.PROXY_NAME, proxytest.SERVICE_PATH, proxytest.SERVICE_INTERFACE, "Sleep",
+                                GLib.Variant("(u)", (0,)), GLib.VariantType.new("(u)"), Gio.DBusCallFlags.NONE,
+                                5000, None).unpack()[0]
+
+
+# Interfaces changed by the count-th resync, from its log line
+def resync_changed(proxy, count):
+    line = proxy.wait_for_line("Resynchronized with restarted source", count)
+    return int(re.search(r": (\d+) interface\(s\) changed", line).group(1))
+
+
+def main():
+    service = proxytest.start_service()
+    proxy = proxytest.start_proxy()
+    failures = []
+
+    try:
+        connection = proxytest.private_connection()
+        if EXTRA_INTERFACE in proxy_interfaces(connection):
+            failures.append("%s mirrored before the service had it" % EXTRA_INTERFACE)
+
+        # Restart with the extra interface
+        service.stop()
+        service = proxytest.start_service("--extra-interface")
+        changed = resync_changed(proxy, 1)
+        print("restart with %s: %d interface(s) changed" % (EXTRA_INTERFACE, changed))
+        if changed != 1:
+            failures.append("adding one interface changed %d" % changed)
+        if EXTRA_INTERFACE not in proxy_interfaces(connection):
+            failures.append("%s not mirrored after the restart" % EXTRA_INTERFACE)
+        reply = call_hello(connection)
+        if reply != "hello":
+            failures.append("Hello through the proxy returned %r" % (reply,))
+        if call_sleep(connection) != 0:
+            failures.append("the unchanged interface no longer forwards")
+
+        # And back without it
+        service.stop()
+        service = proxytest.start_service()
+        changed = resync_changed(proxy, 2)
+        print("restart without %s: %d interface(s) changed" % (EXTRA_INTERFACE, changed))
+        if changed != 1:
+            failures.append("removing one interface changed %d" % changed)
+        if EXTRA_INTERFACE in proxy_interfaces(connection):
+            failures.append("%s still mirrored after the service dropped it" % EXTRA_INTERFACE)
+        reply = call_hello(connection)
+        if not isinstance(reply, GLib.Error):
+            failures.append("Hello still answered through the proxy: %r" % (reply,))
+        if call_sleep(connection) != 0:
+            failures.append("the unchanged interface no longer forwards")
+    finally:
+        proxy.stop()
+        service.stop()
+
+    restarts = proxy.last_counter("restarts")
+    if restarts != 2:
+        failures.append("proxy counted %s source restarts, expected 2" % restarts)
+
+    for failure in failures:
+        print("FAIL: %s" % failure)
+    if not failures:
+        print("PASS")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())